@@ -0,0 +1,110 @@
+#include "ColorsOfEachChannelRequest.h"
+#include "HAL/IConsoleManager.h"
+#include "Async/Async.h"
+
+
+static TAutoConsoleVariable<int32> CVarVertexPaintColorsOfEachChannelMaxConcurrentRequests(
+	TEXT("VertexPaint.ColorsOfEachChannel.MaxConcurrentRequests"),
+	4,
+	TEXT("Max amount of Get Amount Of Painted Colors For Each Channel Async Requests that can run on the thread pool at the same time. The rest waits in a queue until a worker is free. "),
+	ECVF_Default);
+
+
+//-------------------------------------------------------
+
+// Colors Of Each Channel Request Workers
+
+// Keeps the queue of Requests that are waiting and how many workers are running. A worker keeps running Requests from the queue until it's empty, so there are never more than the max amount of them on the thread pool.
+
+class FColorsOfEachChannelRequestWorkers {
+
+public:
+
+	static FColorsOfEachChannelRequestWorkers& Get() {
+
+		static FColorsOfEachChannelRequestWorkers colorsOfEachChannelRequestWorkers;
+		return colorsOfEachChannelRequestWorkers;
+	}
+
+	void QueueRequest(TSharedRef<FColorsOfEachChannelRequest, ESPMode::ThreadSafe> request) {
+
+		{
+			FScopeLock scopeLock_Local(&requestsCriticalSection);
+
+			queuedRequests.Add(request);
+
+			if (amountOfRunningWorkers >= FMath::Max(1, CVarVertexPaintColorsOfEachChannelMaxConcurrentRequests.GetValueOnAnyThread()))
+				return;
+
+			amountOfRunningWorkers++;
+		}
+
+		Async(EAsyncExecution::ThreadPool, [this]() {
+
+			RunQueuedRequests();
+		});
+	}
+
+
+private:
+
+	void RunQueuedRequests() {
+
+		while (true) {
+
+			TSharedPtr<FColorsOfEachChannelRequest, ESPMode::ThreadSafe> requestToRun_Local;
+
+			{
+				FScopeLock scopeLock_Local(&requestsCriticalSection);
+
+				if (queuedRequests.Num() <= 0) {
+
+					amountOfRunningWorkers--;
+					return;
+				}
+
+				// Runs them in the order they where requested
+				requestToRun_Local = queuedRequests[0];
+				queuedRequests.RemoveAt(0);
+			}
+
+			requestToRun_Local->Run();
+		}
+	}
+
+	FCriticalSection requestsCriticalSection;
+	TArray<TSharedRef<FColorsOfEachChannelRequest, ESPMode::ThreadSafe>> queuedRequests;
+	int32 amountOfRunningWorkers = 0;
+};
+
+
+//-------------------------------------------------------
+
+// Colors Of Each Channel Request
+
+FColorsOfEachChannelRequest::FColorsOfEachChannelRequest(FVertexColorsSnapshotRef vertexColors, float minColorAmountToBeConsidered) :
+
+	requestVertexColors(vertexColors),
+	requestMinColorAmountToBeConsidered(minColorAmountToBeConsidered) {
+}
+
+TSharedRef<FColorsOfEachChannelRequest, ESPMode::ThreadSafe> FColorsOfEachChannelRequest::Start(FVertexColorsSnapshotRef vertexColors, float minColorAmountToBeConsidered) {
+
+	TSharedRef<FColorsOfEachChannelRequest, ESPMode::ThreadSafe> request_Local = MakeShared<FColorsOfEachChannelRequest, ESPMode::ThreadSafe>(vertexColors, minColorAmountToBeConsidered);
+
+	FColorsOfEachChannelRequestWorkers::Get().QueueRequest(request_Local);
+
+	return request_Local;
+}
+
+void FColorsOfEachChannelRequest::Run() {
+
+	// If the latent action or world that wanted the result is already gone there's no reason to count anything
+	if (!IsCancelled())
+		amountOfPaintedColorsOfEachChannelResult = VertexPaintFunctions::GetAmountOfPaintedColorsForEachChannel(*requestVertexColors, requestMinColorAmountToBeConsidered);
+
+	// Nothing reads the colors after this so lets go of our reference right away instead of when the last reference to the Request is gone
+	requestVertexColors.Reset();
+
+	isCompleted.store(true, std::memory_order_release);
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LatentActions.h"
+#include "Engine/LatentActionManager.h"
+#include "VertexPaintFunctionLibrary.h"
+#include "VertexColorsSnapshot.h"
+
+#include <atomic>
+
+
+//-------------------------------------------------------
+
+// Colors Of Each Channel Request
+
+// A single Get Amount Of Painted Colors For Each Channel request that runs in the background. Every request holds its own state so any amount of them can be in flight at the same time, and each of them can be Cancelled without affecting the others. They're run on a bounded amount of workers, so if many gets started at once the rest wait in a queue until a worker is free.
+
+class FColorsOfEachChannelRequest : public TSharedFromThis<FColorsOfEachChannelRequest, ESPMode::ThreadSafe> {
+
+public:
+
+	FColorsOfEachChannelRequest(FVertexColorsSnapshotRef vertexColors, float minColorAmountToBeConsidered);
+
+	// Creates a Request and queues it to be run on the worker pool. The Request only holds a reference to the snapshot so nothing gets copied. 
+	static TSharedRef<FColorsOfEachChannelRequest, ESPMode::ThreadSafe> Start(FVertexColorsSnapshotRef vertexColors, float minColorAmountToBeConsidered);
+
+	// If it hasn't started yet it will never run, and if it's running the result will be thrown away. Safe to call from any thread.
+	void Cancel() { isCancelled.store(true, std::memory_order_relaxed); }
+
+	bool IsCancelled() const { return isCancelled.load(std::memory_order_relaxed); }
+
+	bool IsCompleted() const { return isCompleted.load(std::memory_order_acquire); }
+
+	// Only valid when IsCompleted() is true
+	const FVertexDetectAmountOfPaintedColorsOfEachChannel& GetResult() const { return amountOfPaintedColorsOfEachChannelResult; }
+
+	// Run by the worker pool
+	void Run();
+
+
+private:
+
+	FVertexColorsSnapshotPtr requestVertexColors;
+	float requestMinColorAmountToBeConsidered = 0;
+
+	FVertexDetectAmountOfPaintedColorsOfEachChannel amountOfPaintedColorsOfEachChannelResult;
+
+	std::atomic<bool> isCancelled { false };
+	std::atomic<bool> isCompleted { false };
+};
+
+
+//-------------------------------------------------------
+
+// Colors Of Each Channel Request Latent Action
+
+// Polls its Request on the Game Thread and writes the result to the output pin when it's done, so the result is never written to from another thread or after the Blueprint that is waiting for it is gone. If the latent action gets Aborted, or destroyed because its object or world goes away, the Request is Cancelled.
+
+class FColorsOfEachChannelRequestLatentAction : public FPendingLatentAction {
+
+public:
+
+	FColorsOfEachChannelRequestLatentAction(const FLatentActionInfo& latentInfo, TSharedRef<FColorsOfEachChannelRequest, ESPMode::ThreadSafe> request, FVertexDetectAmountOfPaintedColorsOfEachChannel& amountOfColorsOfEachChannelOutput) :
+
+		colorsOfEachChannelRequest(request),
+		amountOfColorsOfEachChannel(amountOfColorsOfEachChannelOutput),
+		executionFunction(latentInfo.ExecutionFunction),
+		outputLink(latentInfo.Linkage),
+		callbackTarget(latentInfo.CallbackTarget) {
+	}
+
+	virtual ~FColorsOfEachChannelRequestLatentAction() {
+
+		colorsOfEachChannelRequest->Cancel();
+	}
+
+	virtual void UpdateOperation(FLatentResponse& Response) override {
+
+		const bool requestCompleted_Local = colorsOfEachChannelRequest->IsCompleted();
+
+		if (requestCompleted_Local)
+			amountOfColorsOfEachChannel = colorsOfEachChannelRequest->GetResult();
+
+		Response.FinishAndTriggerIf(requestCompleted_Local, executionFunction, outputLink, callbackTarget);
+	}
+
+	virtual void NotifyObjectDestroyed() override {
+
+		colorsOfEachChannelRequest->Cancel();
+	}
+
+	virtual void NotifyActionAborted() override {
+
+		colorsOfEachChannelRequest->Cancel();
+	}
+
+#if WITH_EDITOR
+	virtual FString GetDescription() const override {
+
+		return colorsOfEachChannelRequest->IsCompleted() ? TEXT("Colors Of Each Channel Request Completed") : TEXT("Colors Of Each Channel Request Running");
+	}
+#endif
+
+
+private:
+
+	TSharedRef<FColorsOfEachChannelRequest, ESPMode::ThreadSafe> colorsOfEachChannelRequest;
+	FVertexDetectAmountOfPaintedColorsOfEachChannel& amountOfColorsOfEachChannel;
+
+	FName executionFunction;
+	int32 outputLink;
+	FWeakObjectPtr callbackTarget;
+};
@@ -0,0 +1,361 @@
+#include "VertexColorChannelPlanes.h"
+#include "VertexColorsReadView.h"
+#include "VertexColorsGenerations.h"
+#include "Components/PrimitiveComponent.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+
+static TAutoConsoleVariable<int32> CVarVertexPaintChannelPlanesEnableForAllComponents(
+	TEXT("VertexPaint.ChannelPlanes.EnableForAllComponents"),
+	0,
+	TEXT("If 1, every component gets Channel Planes when a single channel is queried, not just the ones that has opted in with Set Channel Planes Enabled. They cost as much memory as the colors themselves. "),
+	ECVF_Default);
+
+
+//-------------------------------------------------------
+
+// Build
+
+FVertexColorChannelPlanes FVertexColorChannelPlanes::Build(TConstArrayView<FColor> vertexColors) {
+
+	FVertexColorChannelPlanes channelPlanes_Local;
+	channelPlanes_Local.amountOfVertices = vertexColors.Num();
+
+	for (TArray<uint8>& channelPlaneTemp : channelPlanes_Local.channelPlanes)
+		channelPlaneTemp.SetNumUninitialized(vertexColors.Num());
+
+
+	uint8* redPlane_Local = channelPlanes_Local.channelPlanes[0].GetData();
+	uint8* greenPlane_Local = channelPlanes_Local.channelPlanes[1].GetData();
+	uint8* bluePlane_Local = channelPlanes_Local.channelPlanes[2].GetData();
+	uint8* alphaPlane_Local = channelPlanes_Local.channelPlanes[3].GetData();
+
+	// Plain loop with no branches so the compiler can vectorize the shuffle
+	for (int32 i = 0; i < vertexColors.Num(); i++) {
+
+		redPlane_Local[i] = vertexColors[i].R;
+		greenPlane_Local[i] = vertexColors[i].G;
+		bluePlane_Local[i] = vertexColors[i].B;
+		alphaPlane_Local[i] = vertexColors[i].A;
+	}
+
+	return channelPlanes_Local;
+}
+
+
+//-------------------------------------------------------
+
+// Count Channel At Min Byte
+
+static void CountChannelPlaneAtMinByte_Scalar(const uint8* channelPlane, int32 amountOfVertices, uint32 minByte, int64& amountOfVerticesAtMinByte, int64& byteSumAtMinByte) {
+
+	for (int32 i = 0; i < amountOfVertices; i++) {
+
+		const int64 passed_Local = channelPlane[i] >= minByte;
+
+		amountOfVerticesAtMinByte += passed_Local;
+		byteSumAtMinByte += passed_Local * channelPlane[i];
+	}
+}
+
+
+#if ENGINE_MAJOR_VERSION == 5 && PLATFORM_ENABLE_VECTORINTRINSICS
+
+template<int32 ByteBitShift>
+FORCEINLINE void CountChannelPlaneAtMinByte_VectorizedByte(const VectorRegister4Int& bytesRegister, const VectorRegister4Int& byteMask, const VectorRegister4Int& minByteMinusOne, VectorRegister4Int& amountPassedAccumulator, VectorRegister4Int& byteSumAccumulator) {
+
+	const VectorRegister4Int bytes_Local = VectorIntAnd(VectorShiftRightImmLogical(bytesRegister, ByteBitShift), byteMask);
+	const VectorRegister4Int passedMask_Local = VectorIntCompareGT(bytes_Local, minByteMinusOne);
+
+	// Passed lanes are all bits set, i.e. -1, so subtracting the mask adds 1 to every lane that passed
+	amountPassedAccumulator = VectorIntSubtract(amountPassedAccumulator, passedMask_Local);
+	byteSumAccumulator = VectorIntAdd(byteSumAccumulator, VectorIntAnd(bytes_Local, passedMask_Local));
+}
+
+static void CountChannelPlaneAtMinByte_Vectorized(const uint8* channelPlane, int32 amountOfVertices, uint32 minByte, int64& amountOfVerticesAtMinByte, int64& byteSumAtMinByte) {
+
+	// Every register holds 16 vertices of the channel, one byte each, where the interleaved colors only fit 4
+	const VectorRegister4Int byteMask_Local = VectorIntSet1(0xFF);
+	const VectorRegister4Int minByteMinusOne_Local = VectorIntSet1(static_cast<int32>(minByte) - 1);
+
+	const int32 verticesPerIteration_Local = 16;
+	const int32 amountOfIterations_Local = amountOfVertices / verticesPerIteration_Local;
+
+	// Each lane can get at most 4 * 255 added to its sum every iteration, so we flush the lanes to the int64 counts well before they could overflow
+	const int32 maxIterationsBeforeFlush_Local = 1 << 20;
+
+
+	int32 iteration_Local = 0;
+
+	while (iteration_Local < amountOfIterations_Local) {
+
+		VectorRegister4Int amountPassed_Local = GlobalVectorConstants::IntZero;
+		VectorRegister4Int byteSum_Local = GlobalVectorConstants::IntZero;
+
+		const int32 lastIterationBeforeFlush_Local = FMath::Min(amountOfIterations_Local, iteration_Local + maxIterationsBeforeFlush_Local);
+
+		for (; iteration_Local < lastIterationBeforeFlush_Local; iteration_Local++) {
+
+			const VectorRegister4Int bytesRegister_Local = VectorIntLoad(channelPlane + iteration_Local * verticesPerIteration_Local);
+
+			CountChannelPlaneAtMinByte_VectorizedByte<0>(bytesRegister_Local, byteMask_Local, minByteMinusOne_Local, amountPassed_Local, byteSum_Local);
+			CountChannelPlaneAtMinByte_VectorizedByte<8>(bytesRegister_Local, byteMask_Local, minByteMinusOne_Local, amountPassed_Local, byteSum_Local);
+			CountChannelPlaneAtMinByte_VectorizedByte<16>(bytesRegister_Local, byteMask_Local, minByteMinusOne_Local, amountPassed_Local, byteSum_Local);
+			CountChannelPlaneAtMinByte_VectorizedByte<24>(bytesRegister_Local, byteMask_Local, minByteMinusOne_Local, amountPassed_Local, byteSum_Local);
+		}
+
+
+		int32 amountPassedLanes_Local[4];
+		int32 byteSumLanes_Local[4];
+
+		VectorIntStore(amountPassed_Local, amountPassedLanes_Local);
+		VectorIntStore(byteSum_Local, byteSumLanes_Local);
+
+		for (int laneIndex = 0; laneIndex < 4; laneIndex++) {
+
+			amountOfVerticesAtMinByte += amountPassedLanes_Local[laneIndex];
+			byteSumAtMinByte += byteSumLanes_Local[laneIndex];
+		}
+	}
+
+
+	// Whatever is left that didn't fill up a whole iteration
+	const int32 amountOfVerticesCounted_Local = amountOfIterations_Local * verticesPerIteration_Local;
+
+	CountChannelPlaneAtMinByte_Scalar(channelPlane + amountOfVerticesCounted_Local, amountOfVertices - amountOfVerticesCounted_Local, minByte, amountOfVerticesAtMinByte, byteSumAtMinByte);
+}
+
+#endif
+
+
+static void CountChannelPlaneAtMinByte(const uint8* channelPlane, int32 amountOfVertices, uint32 minByte, int64& amountOfVerticesAtMinByte, int64& byteSumAtMinByte) {
+
+	if (amountOfVertices <= 0) return;
+	if (minByte > 255) return;
+
+#if ENGINE_MAJOR_VERSION == 5 && PLATFORM_ENABLE_VECTORINTRINSICS
+
+	CountChannelPlaneAtMinByte_Vectorized(channelPlane, amountOfVertices, minByte, amountOfVerticesAtMinByte, byteSumAtMinByte);
+
+#else
+
+	CountChannelPlaneAtMinByte_Scalar(channelPlane, amountOfVertices, minByte, amountOfVerticesAtMinByte, byteSumAtMinByte);
+
+#endif
+}
+
+
+void FVertexColorChannelPlanes::CountChannelAtMinByte(int32 channelIndex, uint32 minByte, int64& amountOfVerticesAtMinByte, int64& byteSumAtMinByte, bool countInParallel) const {
+
+	amountOfVerticesAtMinByte = 0;
+	byteSumAtMinByte = 0;
+
+	if (channelIndex < 0 || channelIndex > 3) return;
+
+	const uint8* channelPlane_Local = channelPlanes[channelIndex].GetData();
+
+	if (!countInParallel) {
+
+		CountChannelPlaneAtMinByte(channelPlane_Local, amountOfVertices, minByte, amountOfVerticesAtMinByte, byteSumAtMinByte);
+		return;
+	}
+
+
+	// 256k vertices per chunk is 256kb of the plane, the same amount of memory as the 64k vertex chunks of the interleaved kernels
+	const int32 verticesPerChunk_Local = 256 * 1024;
+	const int32 amountOfChunks_Local = FMath::DivideAndRoundUp(amountOfVertices, verticesPerChunk_Local);
+
+	TArray<int64> chunksAmountOfVertices_Local;
+	TArray<int64> chunksByteSum_Local;
+	chunksAmountOfVertices_Local.SetNumZeroed(amountOfChunks_Local);
+	chunksByteSum_Local.SetNumZeroed(amountOfChunks_Local);
+
+	ParallelFor(amountOfChunks_Local, [&](int32 chunkIndex) {
+
+		const int32 chunkStartIndex_Local = chunkIndex * verticesPerChunk_Local;
+		const int32 amountOfVerticesInChunk_Local = FMath::Min(verticesPerChunk_Local, amountOfVertices - chunkStartIndex_Local);
+
+		int64 chunkAmountOfVertices_Local = 0;
+		int64 chunkByteSum_Local = 0;
+		CountChannelPlaneAtMinByte(channelPlane_Local + chunkStartIndex_Local, amountOfVerticesInChunk_Local, minByte, chunkAmountOfVertices_Local, chunkByteSum_Local);
+
+		chunksAmountOfVertices_Local[chunkIndex] = chunkAmountOfVertices_Local;
+		chunksByteSum_Local[chunkIndex] = chunkByteSum_Local;
+	});
+
+	for (int32 i = 0; i < amountOfChunks_Local; i++) {
+
+		amountOfVerticesAtMinByte += chunksAmountOfVertices_Local[i];
+		byteSumAtMinByte += chunksByteSum_Local[i];
+	}
+}
+
+
+//-------------------------------------------------------
+
+// Get Allocated Size
+
+int64 FVertexColorChannelPlanes::GetAllocatedSize() const {
+
+	int64 allocatedSize_Local = 0;
+
+	for (const TArray<uint8>& channelPlaneTemp : channelPlanes)
+		allocatedSize_Local += channelPlaneTemp.GetAllocatedSize();
+
+	return allocatedSize_Local;
+}
+
+
+//-------------------------------------------------------
+
+// Get
+
+FVertexColorChannelPlanesCache& FVertexColorChannelPlanesCache::Get() {
+
+	static FVertexColorChannelPlanesCache vertexColorChannelPlanesCache;
+	return vertexColorChannelPlanesCache;
+}
+
+
+//-------------------------------------------------------
+
+// Set Channel Planes Enabled
+
+void FVertexColorChannelPlanesCache::SetChannelPlanesEnabled(const UPrimitiveComponent* meshComponent, bool enabled) {
+
+	if (!IsValid(meshComponent)) return;
+
+
+	FScopeLock scopeLock_Local(&planesCriticalSection);
+
+	// Clears out components that has been destroyed since they will never be queried again
+	for (auto it = enabledComponents.CreateIterator(); it; ++it) {
+
+		if (!it->IsValid())
+			it.RemoveCurrent();
+	}
+
+	if (enabled) {
+
+		enabledComponents.Add(meshComponent);
+		return;
+	}
+
+	enabledComponents.Remove(meshComponent);
+
+	for (auto it = channelPlanesPerComponentLOD.CreateIterator(); it; ++it) {
+
+		if (it.Key().meshComponent == meshComponent)
+			it.RemoveCurrent();
+	}
+}
+
+
+//-------------------------------------------------------
+
+// Is Channel Planes Enabled
+
+bool FVertexColorChannelPlanesCache::IsChannelPlanesEnabled(const UPrimitiveComponent* meshComponent) const {
+
+	if (!IsValid(meshComponent)) return false;
+
+	if (CVarVertexPaintChannelPlanesEnableForAllComponents.GetValueOnAnyThread() != 0) return true;
+
+
+	FScopeLock scopeLock_Local(&planesCriticalSection);
+
+	return enabledComponents.Contains(meshComponent);
+}
+
+
+//-------------------------------------------------------
+
+// Get Channel Planes
+
+FVertexColorChannelPlanesPtr FVertexColorChannelPlanesCache::GetChannelPlanes(UPrimitiveComponent* meshComponent, int32 lod) {
+
+	if (!IsChannelPlanesEnabled(meshComponent)) return nullptr;
+	if (lod < 0) return nullptr;
+
+
+	const uint64 colorsGeneration_Local = FVertexColorsGenerations::Get().GetGeneration(meshComponent, lod);
+
+	{
+		FScopeLock scopeLock_Local(&planesCriticalSection);
+
+		const FCachedChannelPlanes* cachedChannelPlanes_Local = channelPlanesPerComponentLOD.Find({ meshComponent, lod });
+
+		if (cachedChannelPlanes_Local && cachedChannelPlanes_Local->colorsGeneration == colorsGeneration_Local)
+			return cachedChannelPlanes_Local->channelPlanes;
+	}
+
+
+	// Builds them before locking so other threads doesn't have to wait on the loop through the vertices
+	const FVertexColorsReadView vertexColorsReadView_Local = FVertexColorsReadView::Create(meshComponent, lod);
+
+	if (vertexColorsReadView_Local.Num() <= 0) return nullptr;
+
+	FVertexColorChannelPlanesPtr channelPlanes_Local = MakeShared<FVertexColorChannelPlanes, ESPMode::ThreadSafe>(FVertexColorChannelPlanes::Build(vertexColorsReadView_Local.GetColors()));
+
+
+	FScopeLock scopeLock_Local(&planesCriticalSection);
+
+	for (auto it = channelPlanesPerComponentLOD.CreateIterator(); it; ++it) {
+
+		if (!it.Key().meshComponent.IsValid())
+			it.RemoveCurrent();
+	}
+
+	channelPlanesPerComponentLOD.Add({ meshComponent, lod }, FCachedChannelPlanes { channelPlanes_Local, colorsGeneration_Local });
+
+	return channelPlanes_Local;
+}
+
+
+//-------------------------------------------------------
+
+// Set Colors If Cached
+
+void FVertexColorChannelPlanesCache::SetColorsIfCached(const UPrimitiveComponent* meshComponent, int32 lod, TConstArrayView<FColor> vertexColors) {
+
+	if (!IsValid(meshComponent)) return;
+	if (vertexColors.Num() <= 0) return;
+
+	{
+		FScopeLock scopeLock_Local(&planesCriticalSection);
+
+		const FCachedChannelPlanes* cachedChannelPlanes_Local = channelPlanesPerComponentLOD.Find({ meshComponent, lod });
+
+		// If the vertex amount changed they're for another mesh, which the generation check keeps out of queries until they get rebuilt
+		if (!cachedChannelPlanes_Local || cachedChannelPlanes_Local->channelPlanes->GetAmountOfVertices() != vertexColors.Num()) return;
+	}
+
+
+	// Builds them before locking so other threads doesn't have to wait on the loop through the vertices. Queries still counting on the old ones keeps them alive until they're done. 
+	FVertexColorChannelPlanesPtr channelPlanes_Local = MakeShared<FVertexColorChannelPlanes, ESPMode::ThreadSafe>(FVertexColorChannelPlanes::Build(vertexColors));
+
+	FScopeLock scopeLock_Local(&planesCriticalSection);
+
+	channelPlanesPerComponentLOD.Add({ meshComponent, lod }, FCachedChannelPlanes { channelPlanes_Local, FVertexColorsGenerations::Get().GetGeneration(meshComponent, lod) });
+}
+
+
+//-------------------------------------------------------
+
+// Remove Component
+
+void FVertexColorChannelPlanesCache::RemoveComponent(const UPrimitiveComponent* meshComponent) {
+
+	// Compares the weak pointers and not what they point to so it works even if the component is being destroyed. Keeps it enabled though, since it's the cached planes that are outdated and not the choice to have them. 
+	const TWeakObjectPtr<const UPrimitiveComponent> meshComponentToRemove_Local = meshComponent;
+
+	FScopeLock scopeLock_Local(&planesCriticalSection);
+
+	for (auto it = channelPlanesPerComponentLOD.CreateIterator(); it; ++it) {
+
+		if (it.Key().meshComponent == meshComponentToRemove_Local)
+			it.RemoveCurrent();
+	}
+}
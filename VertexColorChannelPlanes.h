@@ -0,0 +1,88 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+#include "Templates/SharedPointer.h"
+
+class UPrimitiveComponent;
+
+
+//-------------------------------------------------------
+
+// Vertex Color Channel Planes
+
+// The colors of a component split into one byte array per channel in the order R, G, B, A, instead of interleaved FColors. Counting how much of a single channel is painted, e.g. how wet something is from the Alpha, only has to stream a quarter of the memory, and 16 vertices of a channel fits in one vector register. Only Get Amount Of Painted Colors For Channel On Component uses them, the other detection and stats still reads the interleaved colors. 
+
+struct FVertexColorChannelPlanes {
+
+	static FVertexColorChannelPlanes Build(TConstArrayView<FColor> vertexColors);
+
+	int32 GetAmountOfVertices() const { return amountOfVertices; }
+
+	// 0 is Red, 1 Green, 2 Blue and 3 Alpha, same as the Color Channels Histogram
+	TConstArrayView<uint8> GetChannelPlane(int32 channelIndex) const { return channelPlanes[channelIndex]; }
+
+	// Amount of vertices with the channel at or above the byte, and the sum of their bytes. Splits it up over several threads with ParallelFor if countInParallel is true. 
+	void CountChannelAtMinByte(int32 channelIndex, uint32 minByte, int64& amountOfVerticesAtMinByte, int64& byteSumAtMinByte, bool countInParallel = false) const;
+
+	int64 GetAllocatedSize() const;
+
+
+private:
+
+	int32 amountOfVertices = 0;
+
+	TArray<uint8> channelPlanes[4];
+};
+
+typedef TSharedPtr<const FVertexColorChannelPlanes, ESPMode::ThreadSafe> FVertexColorChannelPlanesPtr;
+
+
+//-------------------------------------------------------
+
+// Vertex Color Channel Planes Cache
+
+// Optional Channel Planes for the components that has opted in, or for every component if VertexPaint.ChannelPlanes.EnableForAllComponents is 1, since they cost as much memory as the colors themselves. They're built the first time they're queried, and rebuilt from the colors a paint or set task returns when it has applied them on the component, so the next query doesn't have to read them back from the mesh. 
+
+class FVertexColorChannelPlanesCache {
+
+public:
+
+	static FVertexColorChannelPlanesCache& Get();
+
+	void SetChannelPlanesEnabled(const UPrimitiveComponent* meshComponent, bool enabled);
+
+	bool IsChannelPlanesEnabled(const UPrimitiveComponent* meshComponent) const;
+
+	// The planes at the components current color generation, built from its colors if they haven't been, or if they're outdated. Invalid if the component hasn't opted in. 
+	FVertexColorChannelPlanesPtr GetChannelPlanes(UPrimitiveComponent* meshComponent, int32 lod);
+
+	// Same as the Color Channels Stats Cache, only rebuilds them if the component and LOD already has planes for the same amount of vertices. Run by the paint and set tasks callbacks after the color generation has been bumped. 
+	void SetColorsIfCached(const UPrimitiveComponent* meshComponent, int32 lod, TConstArrayView<FColor> vertexColors);
+
+	void RemoveComponent(const UPrimitiveComponent* meshComponent);
+
+
+private:
+
+	struct FPlanesKey {
+
+		TWeakObjectPtr<const UPrimitiveComponent> meshComponent;
+		int32 lod = 0;
+
+		bool operator==(const FPlanesKey& other) const { return meshComponent == other.meshComponent && lod == other.lod; }
+
+		friend uint32 GetTypeHash(const FPlanesKey& planesKey) { return HashCombine(GetTypeHash(planesKey.meshComponent), GetTypeHash(planesKey.lod)); }
+	};
+
+	struct FCachedChannelPlanes {
+
+		FVertexColorChannelPlanesPtr channelPlanes;
+		uint64 colorsGeneration = 0;
+	};
+
+	mutable FCriticalSection planesCriticalSection;
+
+	TSet<TWeakObjectPtr<const UPrimitiveComponent>> enabledComponents;
+	TMap<FPlanesKey, FCachedChannelPlanes> channelPlanesPerComponentLOD;
+};
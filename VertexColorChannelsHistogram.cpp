@@ -0,0 +1,173 @@
+#include "VertexColorChannelsHistogram.h"
+#include "Async/ParallelFor.h"
+
+
+//-------------------------------------------------------
+
+// Build
+
+FVertexColorChannelsHistogram FVertexColorChannelsHistogram::Build(TConstArrayView<FColor> vertexColors, bool buildInParallel) {
+
+	FVertexColorChannelsHistogram histogram_Local;
+
+	if (!buildInParallel) {
+
+		histogram_Local.AddColors(vertexColors);
+		return histogram_Local;
+	}
+
+
+	// Same chunk size as when counting colors of each channel in parallel, i.e. 256kb of colors per chunk
+	const int32 verticesPerChunk_Local = 64 * 1024;
+	const int32 amountOfChunks_Local = FMath::DivideAndRoundUp(vertexColors.Num(), verticesPerChunk_Local);
+
+	TArray<FVertexColorChannelsHistogram> chunkHistograms_Local;
+	chunkHistograms_Local.SetNum(amountOfChunks_Local);
+
+	ParallelFor(amountOfChunks_Local, [&](int32 chunkIndex) {
+
+		const int32 chunkStartIndex_Local = chunkIndex * verticesPerChunk_Local;
+		const int32 amountOfVerticesInChunk_Local = FMath::Min(verticesPerChunk_Local, vertexColors.Num() - chunkStartIndex_Local);
+
+		chunkHistograms_Local[chunkIndex].AddColors(vertexColors.Slice(chunkStartIndex_Local, amountOfVerticesInChunk_Local));
+	});
+
+	for (const FVertexColorChannelsHistogram& chunkHistogramTemp : chunkHistograms_Local)
+		histogram_Local.Merge(chunkHistogramTemp);
+
+	return histogram_Local;
+}
+
+
+//-------------------------------------------------------
+
+// Reset
+
+void FVertexColorChannelsHistogram::Reset() {
+
+	FMemory::Memzero(amountOfVerticesWithByte, sizeof(amountOfVerticesWithByte));
+	amountOfVertices = 0;
+}
+
+
+//-------------------------------------------------------
+
+// Add Colors
+
+void FVertexColorChannelsHistogram::AddColors(TConstArrayView<FColor> vertexColors) {
+
+	if (vertexColors.Num() <= 0) return;
+
+
+	// Painted meshes often have long runs of vertices with the exact same color, so if we incremented the same counter for every vertex each increment would have to wait for the previous one. With two tables that every other vertex goes into, neighbouring vertices never wait on each other. They're added together at the end. 
+	uint32 interleavedCounts_Local[2][4][256];
+	FMemory::Memzero(interleavedCounts_Local, sizeof(interleavedCounts_Local));
+
+	const FColor* colors_Local = vertexColors.GetData();
+	const int32 amountOfPairs_Local = vertexColors.Num() / 2;
+
+	for (int32 i = 0; i < amountOfPairs_Local; i++) {
+
+		const FColor& firstColor_Local = colors_Local[i * 2];
+		const FColor& secondColor_Local = colors_Local[i * 2 + 1];
+
+		interleavedCounts_Local[0][RedChannelIndex][firstColor_Local.R]++;
+		interleavedCounts_Local[0][GreenChannelIndex][firstColor_Local.G]++;
+		interleavedCounts_Local[0][BlueChannelIndex][firstColor_Local.B]++;
+		interleavedCounts_Local[0][AlphaChannelIndex][firstColor_Local.A]++;
+
+		interleavedCounts_Local[1][RedChannelIndex][secondColor_Local.R]++;
+		interleavedCounts_Local[1][GreenChannelIndex][secondColor_Local.G]++;
+		interleavedCounts_Local[1][BlueChannelIndex][secondColor_Local.B]++;
+		interleavedCounts_Local[1][AlphaChannelIndex][secondColor_Local.A]++;
+	}
+
+	// If odd amount of vertices
+	if (vertexColors.Num() % 2 != 0) {
+
+		const FColor& lastColor_Local = colors_Local[vertexColors.Num() - 1];
+
+		interleavedCounts_Local[0][RedChannelIndex][lastColor_Local.R]++;
+		interleavedCounts_Local[0][GreenChannelIndex][lastColor_Local.G]++;
+		interleavedCounts_Local[0][BlueChannelIndex][lastColor_Local.B]++;
+		interleavedCounts_Local[0][AlphaChannelIndex][lastColor_Local.A]++;
+	}
+
+
+	for (int32 channelIndex = 0; channelIndex < 4; channelIndex++) {
+
+		for (int32 byteValue = 0; byteValue < 256; byteValue++)
+			amountOfVerticesWithByte[channelIndex][byteValue] += interleavedCounts_Local[0][channelIndex][byteValue] + interleavedCounts_Local[1][channelIndex][byteValue];
+	}
+
+	amountOfVertices += vertexColors.Num();
+}
+
+
+//-------------------------------------------------------
+
+// Merge
+
+void FVertexColorChannelsHistogram::Merge(const FVertexColorChannelsHistogram& otherHistogram) {
+
+	for (int32 channelIndex = 0; channelIndex < 4; channelIndex++) {
+
+		for (int32 byteValue = 0; byteValue < 256; byteValue++)
+			amountOfVerticesWithByte[channelIndex][byteValue] += otherHistogram.amountOfVerticesWithByte[channelIndex][byteValue];
+	}
+
+	amountOfVertices += otherHistogram.amountOfVertices;
+}
+
+
+//-------------------------------------------------------
+
+// Queries
+
+int64 FVertexColorChannelsHistogram::GetAmountOfVerticesAtMinByte(int32 channelIndex, uint32 byteThreshold) const {
+
+	int64 amountOfVerticesAtMinByte_Local = 0;
+
+	for (uint32 byteValue = byteThreshold; byteValue < 256; byteValue++)
+		amountOfVerticesAtMinByte_Local += amountOfVerticesWithByte[channelIndex][byteValue];
+
+	return amountOfVerticesAtMinByte_Local;
+}
+
+int64 FVertexColorChannelsHistogram::GetByteSumAtMinByte(int32 channelIndex, uint32 byteThreshold) const {
+
+	int64 byteSumAtMinByte_Local = 0;
+
+	for (uint32 byteValue = byteThreshold; byteValue < 256; byteValue++)
+		byteSumAtMinByte_Local += static_cast<int64>(amountOfVerticesWithByte[channelIndex][byteValue]) * byteValue;
+
+	return byteSumAtMinByte_Local;
+}
+
+float FVertexColorChannelsHistogram::GetAverageColorAmount(int32 channelIndex) const {
+
+	if (amountOfVertices <= 0) return 0;
+
+	return static_cast<float>(static_cast<double>(GetByteSumAtMinByte(channelIndex, 0)) / 255.0 / amountOfVertices);
+}
+
+float FVertexColorChannelsHistogram::GetColorAmountAtPercentile(int32 channelIndex, float percentile) const {
+
+	if (amountOfVertices <= 0) return 0;
+
+
+	// The amount of vertices that has to be at or below the byte we return, at least 1 so percentile 0 returns the lowest byte any vertex has
+	const int64 amountOfVerticesToReach_Local = FMath::Max<int64>(1, static_cast<int64>(FMath::CeilToDouble(static_cast<double>(FMath::Clamp(percentile, 0.f, 1.f)) * amountOfVertices)));
+
+	int64 amountOfVerticesAtOrBelow_Local = 0;
+
+	for (int32 byteValue = 0; byteValue < 256; byteValue++) {
+
+		amountOfVerticesAtOrBelow_Local += amountOfVerticesWithByte[channelIndex][byteValue];
+
+		if (amountOfVerticesAtOrBelow_Local >= amountOfVerticesToReach_Local)
+			return byteValue / 255.f;
+	}
+
+	return 1;
+}
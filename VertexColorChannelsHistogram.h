@@ -0,0 +1,84 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+//-------------------------------------------------------
+
+// Vertex Color Channels Histogram
+
+// How many vertices has each of the 256 byte values, for each channel in the order R, G, B, A. It's built in one pass over the colors, and after that the amount painted, averages, percentiles and medians for any min color amount can be gotten from it in 256 steps without looking at the vertices again. So if you need to check the same colors at several thresholds, for instance 0.1 for damp, 0.5 for wet and 0.9 for soaked, you only have to loop through the vertices once.
+
+struct FVertexColorChannelsHistogram {
+
+	static const int32 RedChannelIndex = 0;
+	static const int32 GreenChannelIndex = 1;
+	static const int32 BlueChannelIndex = 2;
+	static const int32 AlphaChannelIndex = 3;
+
+
+	FVertexColorChannelsHistogram() { Reset(); }
+
+	// Builds the histogram in one pass. If buildInParallel is true the colors gets split into chunks that are counted with ParallelFor and merged. 
+	static FVertexColorChannelsHistogram Build(TConstArrayView<FColor> vertexColors, bool buildInParallel = false);
+
+	void Reset();
+
+	void AddColors(TConstArrayView<FColor> vertexColors);
+
+	void AddColor(const FColor& color) {
+
+		amountOfVerticesWithByte[RedChannelIndex][color.R]++;
+		amountOfVerticesWithByte[GreenChannelIndex][color.G]++;
+		amountOfVerticesWithByte[BlueChannelIndex][color.B]++;
+		amountOfVerticesWithByte[AlphaChannelIndex][color.A]++;
+		amountOfVertices++;
+	}
+
+	// Adds the same color for several vertices at once, e.g. for meshes that has never been painted and are all one color
+	void AddUniformColor(const FColor& color, int32 amountOfVerticesWithColor) {
+
+		amountOfVerticesWithByte[RedChannelIndex][color.R] += amountOfVerticesWithColor;
+		amountOfVerticesWithByte[GreenChannelIndex][color.G] += amountOfVerticesWithColor;
+		amountOfVerticesWithByte[BlueChannelIndex][color.B] += amountOfVerticesWithColor;
+		amountOfVerticesWithByte[AlphaChannelIndex][color.A] += amountOfVerticesWithColor;
+		amountOfVertices += amountOfVerticesWithColor;
+	}
+
+	// Removes a color that has previously been added, so the histogram can be kept up to date with just the vertices that changed
+	void RemoveColor(const FColor& color) {
+
+		amountOfVerticesWithByte[RedChannelIndex][color.R]--;
+		amountOfVerticesWithByte[GreenChannelIndex][color.G]--;
+		amountOfVerticesWithByte[BlueChannelIndex][color.B]--;
+		amountOfVerticesWithByte[AlphaChannelIndex][color.A]--;
+		amountOfVertices--;
+	}
+
+	void Merge(const FVertexColorChannelsHistogram& otherHistogram);
+
+
+	int32 GetAmountOfVertices() const { return amountOfVertices; }
+
+	uint32 GetAmountOfVerticesWithByte(int32 channelIndex, uint8 byteValue) const { return amountOfVerticesWithByte[channelIndex][byteValue]; }
+
+	// Amount of vertices on the channel with a byte value of byteThreshold or more
+	int64 GetAmountOfVerticesAtMinByte(int32 channelIndex, uint32 byteThreshold) const;
+
+	// Sum of the byte values of the vertices on the channel with a byte value of byteThreshold or more
+	int64 GetByteSumAtMinByte(int32 channelIndex, uint32 byteThreshold) const;
+
+	// Average color amount 0-1 of all vertices on the channel
+	float GetAverageColorAmount(int32 channelIndex) const;
+
+	// The color amount 0-1 that percentile 0-1 of the vertices on the channel are at or below, i.e. 0.5 is the median
+	float GetColorAmountAtPercentile(int32 channelIndex, float percentile) const;
+
+	float GetMedianColorAmount(int32 channelIndex) const { return GetColorAmountAtPercentile(channelIndex, 0.5f); }
+
+
+private:
+
+	uint32 amountOfVerticesWithByte[4][256];
+	int32 amountOfVertices = 0;
+};
@@ -0,0 +1,109 @@
+#include "VertexColorChannelsStatsCache.h"
+#include "VertexColorsGenerations.h"
+#include "Components/PrimitiveComponent.h"
+
+
+//-------------------------------------------------------
+
+// Get
+
+FVertexColorChannelsStatsCache& FVertexColorChannelsStatsCache::Get() {
+
+	static FVertexColorChannelsStatsCache vertexColorChannelsStatsCache;
+	return vertexColorChannelsStatsCache;
+}
+
+
+//-------------------------------------------------------
+
+// Set Colors
+
+void FVertexColorChannelsStatsCache::SetColors(const UPrimitiveComponent* meshComponent, int32 lod, TConstArrayView<FColor> vertexColors) {
+
+	if (!IsValid(meshComponent)) return;
+
+
+	// Builds it before locking so other threads doesn't have to wait on the loop through the vertices
+	SetColorChannelsHistogram(meshComponent, lod, FVertexColorChannelsHistogram::Build(vertexColors));
+}
+
+void FVertexColorChannelsStatsCache::SetColorChannelsHistogram(const UPrimitiveComponent* meshComponent, int32 lod, const FVertexColorChannelsHistogram& colorChannelsHistogram) {
+
+	if (!IsValid(meshComponent)) return;
+
+
+	FScopeLock scopeLock_Local(&statsCriticalSection);
+
+	// Clears out components that has been destroyed since they will never be queried again
+	for (auto it = colorChannelsHistogramPerComponentLOD.CreateIterator(); it; ++it) {
+
+		if (!it.Key().meshComponent.IsValid())
+			it.RemoveCurrent();
+	}
+
+	colorChannelsHistogramPerComponentLOD.Add({ meshComponent, lod }, FCachedColorChannelsStats { colorChannelsHistogram, FVertexColorsGenerations::Get().GetGeneration(meshComponent, lod) });
+}
+
+
+//-------------------------------------------------------
+
+// Set Colors If Cached
+
+void FVertexColorChannelsStatsCache::SetColorsIfCached(const UPrimitiveComponent* meshComponent, int32 lod, TConstArrayView<FColor> vertexColors) {
+
+	if (!IsValid(meshComponent)) return;
+	if (vertexColors.Num() <= 0) return;
+
+	{
+		FScopeLock scopeLock_Local(&statsCriticalSection);
+
+		const FCachedColorChannelsStats* cachedStats_Local = colorChannelsHistogramPerComponentLOD.Find({ meshComponent, lod });
+
+		// If the vertex amount changed the histogram is for another mesh, which the generation check will keep out of queries until it gets rebuilt
+		if (!cachedStats_Local || cachedStats_Local->colorChannelsHistogram.GetAmountOfVertices() != vertexColors.Num()) return;
+	}
+
+	SetColors(meshComponent, lod, vertexColors);
+}
+
+
+//-------------------------------------------------------
+
+// Get Color Channels Histogram
+
+bool FVertexColorChannelsStatsCache::GetColorChannelsHistogram(const UPrimitiveComponent* meshComponent, int32 lod, FVertexColorChannelsHistogram& colorChannelsHistogram) const {
+
+	if (!IsValid(meshComponent)) return false;
+
+
+	FScopeLock scopeLock_Local(&statsCriticalSection);
+
+	if (const FCachedColorChannelsStats* cachedStats_Local = colorChannelsHistogramPerComponentLOD.Find({ meshComponent, lod })) {
+
+		if (cachedStats_Local->colorsGeneration != FVertexColorsGenerations::Get().GetGeneration(meshComponent, lod)) return false;
+
+		colorChannelsHistogram = cachedStats_Local->colorChannelsHistogram;
+		return true;
+	}
+
+	return false;
+}
+
+
+//-------------------------------------------------------
+
+// Remove Component
+
+void FVertexColorChannelsStatsCache::RemoveComponent(const UPrimitiveComponent* meshComponent) {
+
+	// Compares the weak pointers and not what they point to so it works even if the component is being destroyed
+	const TWeakObjectPtr<const UPrimitiveComponent> meshComponentToRemove_Local = meshComponent;
+
+	FScopeLock scopeLock_Local(&statsCriticalSection);
+
+	for (auto it = colorChannelsHistogramPerComponentLOD.CreateIterator(); it; ++it) {
+
+		if (it.Key().meshComponent == meshComponentToRemove_Local)
+			it.RemoveCurrent();
+	}
+}
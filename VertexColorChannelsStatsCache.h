@@ -0,0 +1,58 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+#include "VertexColorChannelsHistogram.h"
+
+class UPrimitiveComponent;
+
+
+//-------------------------------------------------------
+
+// Vertex Color Channels Stats Cache
+
+// Keeps a Color Channels Histogram for every queried component and LOD that is built from its colors the first time it's queried, and rebuilt from the colors a paint or set task returns when it has applied them on the component, so the next query doesn't have to read them back from the mesh. So queries like how much of a component is painted at a min amount doesn't have to loop through all of the vertices again, just the 256 byte values of the histogram.
+
+class FVertexColorChannelsStatsCache {
+
+public:
+
+	static FVertexColorChannelsStatsCache& Get();
+
+	// Replaces the stats with the given colors, for instance when a task has Set all of the colors or the first time we read the colors of a component
+	void SetColors(const UPrimitiveComponent* meshComponent, int32 lod, TConstArrayView<FColor> vertexColors);
+
+	void SetColorChannelsHistogram(const UPrimitiveComponent* meshComponent, int32 lod, const FVertexColorChannelsHistogram& colorChannelsHistogram);
+
+	// Same as Set Colors but only if the component and LOD has been queried before and is for the same amount of vertices, so tasks doesn't build stats for every component they paint on that no one is asking for. Run by the paint and set tasks callbacks with the colors they applied, after the color generation has been bumped. 
+	void SetColorsIfCached(const UPrimitiveComponent* meshComponent, int32 lod, TConstArrayView<FColor> vertexColors);
+
+	// False if not cached, or if the colors has changed in a way we couldn't keep the stats up to date with, e.g. if they were Set directly
+	bool GetColorChannelsHistogram(const UPrimitiveComponent* meshComponent, int32 lod, FVertexColorChannelsHistogram& colorChannelsHistogram) const;
+
+	// When the colors no longer match what we've cached, for instance if the mesh got switched
+	void RemoveComponent(const UPrimitiveComponent* meshComponent);
+
+
+private:
+
+	struct FStatsKey {
+
+		TWeakObjectPtr<const UPrimitiveComponent> meshComponent;
+		int32 lod = 0;
+
+		bool operator==(const FStatsKey& other) const { return meshComponent == other.meshComponent && lod == other.lod; }
+
+		friend uint32 GetTypeHash(const FStatsKey& statsKey) { return HashCombine(GetTypeHash(statsKey.meshComponent), GetTypeHash(statsKey.lod)); }
+	};
+
+	// The histogram together with the color generation of the component that it's for
+	struct FCachedColorChannelsStats {
+
+		FVertexColorChannelsHistogram colorChannelsHistogram;
+		uint64 colorsGeneration = 0;
+	};
+
+	mutable FCriticalSection statsCriticalSection;
+	TMap<FStatsKey, FCachedColorChannelsStats> colorChannelsHistogramPerComponentLOD;
+};
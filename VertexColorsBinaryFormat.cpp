@@ -0,0 +1,237 @@
+#include "VertexColorsBinaryFormat.h"
+#include "Misc/Compression.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Hash/CityHash.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+
+//-------------------------------------------------------
+
+// Serialize Header
+
+static void SerializeVertexColorsBinaryHeader(FArchive& archive, FVertexColorsBinaryHeader& header) {
+
+	uint8 compression_Local = static_cast<uint8>(header.compression);
+
+	archive << header.magic;
+	archive << header.version;
+	archive << header.encodingFlags;
+	archive << compression_Local;
+	archive << header.sourceMeshId;
+	archive << header.amountOfVertices;
+	archive << header.storedPayloadSize;
+
+	header.compression = static_cast<EVertexColorsBinaryCompression>(compression_Local);
+}
+
+
+//-------------------------------------------------------
+
+// Get Source Mesh Id
+
+uint64 FVertexColorsBinaryFormat::GetSourceMeshId(const UObject* sourceMesh) {
+
+	if (!IsValid(sourceMesh)) return 0;
+
+	// The path and not the pointer so it's the same between sessions
+	const FString sourceMeshPath_Local = sourceMesh->GetPathName();
+
+	return CityHash64(reinterpret_cast<const char*>(*sourceMeshPath_Local), sourceMeshPath_Local.Len() * sizeof(TCHAR));
+}
+
+
+//-------------------------------------------------------
+
+// Get Compression Format Name
+
+FName FVertexColorsBinaryFormat::GetCompressionFormatName(EVertexColorsBinaryCompression compression) {
+
+	switch (compression) {
+
+	case EVertexColorsBinaryCompression::LZ4:
+		return NAME_LZ4;
+
+#if ENGINE_MAJOR_VERSION == 5
+
+	case EVertexColorsBinaryCompression::Oodle:
+		return NAME_Oodle;
+
+#endif
+
+	default:
+		break;
+	}
+
+	return NAME_None;
+}
+
+
+//-------------------------------------------------------
+
+// Encode
+
+bool FVertexColorsBinaryFormat::Encode(TConstArrayView<FColor> vertexColors, const UObject* sourceMesh, TConstArrayView<FColor> sourceMeshColors, EVertexColorsBinaryCompression compression, TArray<uint8>& binaryColorData) {
+
+	binaryColorData.Reset();
+
+	if (vertexColors.Num() <= 0) return false;
+
+
+	FVertexColorsBinaryHeader header_Local;
+	header_Local.sourceMeshId = GetSourceMeshId(sourceMesh);
+	header_Local.amountOfVertices = vertexColors.Num();
+
+	const bool deltaEncode_Local = sourceMeshColors.Num() == vertexColors.Num();
+
+	if (deltaEncode_Local)
+		header_Local.encodingFlags |= FVertexColorsBinaryHeader::DeltaEncodedFlag;
+
+
+	// Splits into planes, and if delta encoded subtracts the default color with wrap around so it can be added back exactly
+	TArray<uint8> payload_Local;
+	payload_Local.SetNumUninitialized(header_Local.GetPayloadSize());
+
+	const int32 amountOfVertices_Local = vertexColors.Num();
+	uint8* redPlane_Local = payload_Local.GetData();
+	uint8* greenPlane_Local = redPlane_Local + amountOfVertices_Local;
+	uint8* bluePlane_Local = greenPlane_Local + amountOfVertices_Local;
+	uint8* alphaPlane_Local = bluePlane_Local + amountOfVertices_Local;
+
+	for (int32 i = 0; i < amountOfVertices_Local; i++) {
+
+		const FColor defaultColor_Local = deltaEncode_Local ? sourceMeshColors[i] : FColor(0, 0, 0, 0);
+
+		redPlane_Local[i] = static_cast<uint8>(vertexColors[i].R - defaultColor_Local.R);
+		greenPlane_Local[i] = static_cast<uint8>(vertexColors[i].G - defaultColor_Local.G);
+		bluePlane_Local[i] = static_cast<uint8>(vertexColors[i].B - defaultColor_Local.B);
+		alphaPlane_Local[i] = static_cast<uint8>(vertexColors[i].A - defaultColor_Local.A);
+	}
+
+
+	TArray<uint8> compressedPayload_Local;
+	const FName compressionFormatName_Local = GetCompressionFormatName(compression);
+
+	if (compressionFormatName_Local != NAME_None) {
+
+		int32 compressedSize_Local = FCompression::CompressMemoryBound(compressionFormatName_Local, payload_Local.Num());
+		compressedPayload_Local.SetNumUninitialized(compressedSize_Local);
+
+		// If it failed, or didn't make it any smaller, the payload is stored as it is
+		if (FCompression::CompressMemory(compressionFormatName_Local, compressedPayload_Local.GetData(), compressedSize_Local, payload_Local.GetData(), payload_Local.Num()) && compressedSize_Local < payload_Local.Num()) {
+
+			compressedPayload_Local.SetNum(compressedSize_Local);
+			header_Local.compression = compression;
+		}
+
+		else {
+
+			compressedPayload_Local.Empty();
+		}
+	}
+
+	const TArray<uint8>& storedPayload_Local = header_Local.compression != EVertexColorsBinaryCompression::None ? compressedPayload_Local : payload_Local;
+	header_Local.storedPayloadSize = storedPayload_Local.Num();
+
+
+	binaryColorData.Reserve(FVertexColorsBinaryHeader::SerializedSize + storedPayload_Local.Num());
+
+	FMemoryWriter memoryWriter_Local(binaryColorData);
+	SerializeVertexColorsBinaryHeader(memoryWriter_Local, header_Local);
+
+	binaryColorData.Append(storedPayload_Local);
+
+	return true;
+}
+
+
+//-------------------------------------------------------
+
+// Read Header
+
+bool FVertexColorsBinaryFormat::ReadHeader(TConstArrayView<uint8> binaryColorData, FVertexColorsBinaryHeader& header) {
+
+	if (binaryColorData.Num() < FVertexColorsBinaryHeader::SerializedSize) return false;
+
+
+	// The reader wants a TArray so only the header bytes are copied into one
+	TArray<uint8> headerBytes_Local(binaryColorData.GetData(), FVertexColorsBinaryHeader::SerializedSize);
+
+	FMemoryReader memoryReader_Local(headerBytes_Local);
+	SerializeVertexColorsBinaryHeader(memoryReader_Local, header);
+
+	if (memoryReader_Local.IsError()) return false;
+	if (header.magic != FVertexColorsBinaryHeader::Magic) return false;
+	if (header.version == 0 || header.version > FVertexColorsBinaryHeader::CurrentVersion) return false;
+	if (header.amountOfVertices <= 0 || header.amountOfVertices > MAX_int32 / 4) return false;
+	if (header.storedPayloadSize <= 0 || header.storedPayloadSize > binaryColorData.Num() - FVertexColorsBinaryHeader::SerializedSize) return false;
+
+	return true;
+}
+
+
+//-------------------------------------------------------
+
+// Decode
+
+bool FVertexColorsBinaryFormat::Decode(TConstArrayView<uint8> binaryColorData, const UObject* sourceMesh, TConstArrayView<FColor> sourceMeshColors, TArray<FColor>& vertexColors) {
+
+	vertexColors.Reset();
+
+	FVertexColorsBinaryHeader header_Local;
+
+	if (!ReadHeader(binaryColorData, header_Local)) return false;
+	if (header_Local.sourceMeshId != GetSourceMeshId(sourceMesh)) return false;
+	if (header_Local.IsDeltaEncoded() && sourceMeshColors.Num() != header_Local.amountOfVertices) return false;
+
+
+	const uint8* storedPayload_Local = binaryColorData.GetData() + FVertexColorsBinaryHeader::SerializedSize;
+	const uint8* payload_Local = storedPayload_Local;
+	TArray<uint8> uncompressedPayload_Local;
+
+	if (header_Local.compression != EVertexColorsBinaryCompression::None) {
+
+		const FName compressionFormatName_Local = GetCompressionFormatName(header_Local.compression);
+
+		if (compressionFormatName_Local == NAME_None) return false;
+
+		uncompressedPayload_Local.SetNumUninitialized(header_Local.GetPayloadSize());
+
+		if (!FCompression::UncompressMemory(compressionFormatName_Local, uncompressedPayload_Local.GetData(), uncompressedPayload_Local.Num(), storedPayload_Local, header_Local.storedPayloadSize)) return false;
+
+		payload_Local = uncompressedPayload_Local.GetData();
+	}
+
+	else if (header_Local.storedPayloadSize != header_Local.GetPayloadSize()) {
+
+		return false;
+	}
+
+
+	const int32 amountOfVertices_Local = header_Local.amountOfVertices;
+	const uint8* redPlane_Local = payload_Local;
+	const uint8* greenPlane_Local = redPlane_Local + amountOfVertices_Local;
+	const uint8* bluePlane_Local = greenPlane_Local + amountOfVertices_Local;
+	const uint8* alphaPlane_Local = bluePlane_Local + amountOfVertices_Local;
+
+	vertexColors.SetNumUninitialized(amountOfVertices_Local);
+	FColor* vertexColorsData_Local = vertexColors.GetData();
+
+	if (header_Local.IsDeltaEncoded()) {
+
+		for (int32 i = 0; i < amountOfVertices_Local; i++) {
+
+			const FColor& defaultColor_Local = sourceMeshColors[i];
+
+			vertexColorsData_Local[i] = FColor(static_cast<uint8>(redPlane_Local[i] + defaultColor_Local.R), static_cast<uint8>(greenPlane_Local[i] + defaultColor_Local.G), static_cast<uint8>(bluePlane_Local[i] + defaultColor_Local.B), static_cast<uint8>(alphaPlane_Local[i] + defaultColor_Local.A));
+		}
+	}
+
+	else {
+
+		for (int32 i = 0; i < amountOfVertices_Local; i++)
+			vertexColorsData_Local[i] = FColor(redPlane_Local[i], greenPlane_Local[i], bluePlane_Local[i], alphaPlane_Local[i]);
+	}
+
+	return true;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+//-------------------------------------------------------
+
+// Vertex Colors Binary Format
+
+// A compact, versioned binary alternative to the serialized color string, so saves doesn't have to store several characters per vertex and parse them on load. 
+// Layout is a fixed size header followed by the payload. The payload is the colors as four planes of bytes, R, G, B then A, since each channel on its own has long runs of the same value that compresses well. If delta encoded, each byte is stored as the difference from the source mesh's default color of the vertex, so vertices that hasn't been painted becomes 0. 
+
+enum class EVertexColorsBinaryCompression : uint8 {
+
+	None = 0,
+	LZ4 = 1,
+	Oodle = 2,
+};
+
+
+struct FVertexColorsBinaryHeader {
+
+	static const uint32 Magic = 0x42435056; // VPCB
+	static const uint16 CurrentVersion = 1;
+
+	static const uint8 DeltaEncodedFlag = 1 << 0;
+
+	uint32 magic = Magic;
+	uint16 version = CurrentVersion;
+	uint8 encodingFlags = 0;
+	EVertexColorsBinaryCompression compression = EVertexColorsBinaryCompression::None;
+
+	// Hash of the source mesh's path, so colors doesn't get applied to another mesh than the one they were saved from
+	uint64 sourceMeshId = 0;
+
+	int32 amountOfVertices = 0;
+	int32 storedPayloadSize = 0;
+
+	bool IsDeltaEncoded() const { return (encodingFlags & DeltaEncodedFlag) != 0; }
+
+	// Uncompressed it's always one byte per channel for each vertex
+	int32 GetPayloadSize() const { return amountOfVertices * 4; }
+
+	static constexpr int32 SerializedSize = 4 + 2 + 1 + 1 + 8 + 4 + 4;
+};
+
+
+class FVertexColorsBinaryFormat {
+
+public:
+
+	static uint64 GetSourceMeshId(const UObject* sourceMesh);
+
+	// sourceMeshColors are the source mesh's own colors at LOD0. If there are as many of them as vertexColors the colors gets delta encoded against them, otherwise they're stored as they are. 
+	static bool Encode(TConstArrayView<FColor> vertexColors, const UObject* sourceMesh, TConstArrayView<FColor> sourceMeshColors, EVertexColorsBinaryCompression compression, TArray<uint8>& binaryColorData);
+
+	static bool ReadHeader(TConstArrayView<uint8> binaryColorData, FVertexColorsBinaryHeader& header);
+
+	// Fails if the data is for another mesh, is a version we don't know about, or is delta encoded and sourceMeshColors doesn't match. The colors are decoded straight into vertexColors, which is resized to fit. 
+	static bool Decode(TConstArrayView<uint8> binaryColorData, const UObject* sourceMesh, TConstArrayView<FColor> sourceMeshColors, TArray<FColor>& vertexColors);
+
+
+private:
+
+	static FName GetCompressionFormatName(EVertexColorsBinaryCompression compression);
+};
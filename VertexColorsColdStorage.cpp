@@ -0,0 +1,574 @@
+#include "VertexColorsColdStorage.h"
+#include "VertexPaintFunctionLibrary.h"
+#include "VertexColorsGenerations.h"
+#include "VertexColorsSnapshotDedupCache.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "StaticMeshResources.h"
+#include "Rendering/ColorVertexBuffer.h"
+#include "ComponentRecreateRenderStateContext.h"
+#include "RenderingThread.h"
+#include "HAL/IConsoleManager.h"
+
+
+static TAutoConsoleVariable<float> CVarVertexPaintColdStorageIdleSeconds(
+	TEXT("VertexPaint.ColdStorage.IdleSeconds"),
+	0.f,
+	TEXT("How many seconds a painted static mesh component has to go without being read from or painted on before the CPU side copy of its override vertex colors gets compressed. 0 or less disables cold storage. "),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarVertexPaintColdStorageBudgetMB(
+	TEXT("VertexPaint.ColdStorage.BudgetMB"),
+	0,
+	TEXT("If the uncompressed CPU side override vertex colors of the tracked components goes above this many MB, the least recently used ones gets compressed even if they haven't been idle long enough. 0 or less means no budget. "),
+	ECVF_Default);
+
+
+//-------------------------------------------------------
+
+// Compress
+
+FCompressedVertexColors FCompressedVertexColors::Compress(TConstArrayView<FColor> vertexColors) {
+
+	FCompressedVertexColors compressedVertexColors_Local;
+	compressedVertexColors_Local.amountOfVertices = vertexColors.Num();
+
+	if (vertexColors.Num() <= 0) return compressedVertexColors_Local;
+
+
+	// Builds the palette until there are more distinct colors than a byte can index
+	TMap<uint32, uint8> paletteIndices_Local;
+	compressedVertexColors_Local.usesPalette = true;
+
+	for (const FColor& vertexColorTemp : vertexColors) {
+
+		if (paletteIndices_Local.Contains(vertexColorTemp.DWColor())) continue;
+
+		if (compressedVertexColors_Local.palette.Num() >= 256) {
+
+			compressedVertexColors_Local.usesPalette = false;
+			compressedVertexColors_Local.palette.Empty();
+			break;
+		}
+
+		paletteIndices_Local.Add(vertexColorTemp.DWColor(), static_cast<uint8>(compressedVertexColors_Local.palette.Num()));
+		compressedVertexColors_Local.palette.Add(vertexColorTemp);
+	}
+
+
+	TArray<uint8>& encodedRuns_Local = compressedVertexColors_Local.encodedRuns;
+	int32 runStart_Local = 0;
+
+	while (runStart_Local < vertexColors.Num()) {
+
+		int32 runEnd_Local = runStart_Local + 1;
+
+		while (runEnd_Local < vertexColors.Num() && vertexColors[runEnd_Local] == vertexColors[runStart_Local])
+			runEnd_Local++;
+
+
+		uint32 runLength_Local = static_cast<uint32>(runEnd_Local - runStart_Local);
+
+		do {
+
+			encodedRuns_Local.Add(static_cast<uint8>((runLength_Local & 0x7F) | (runLength_Local > 0x7F ? 0x80 : 0)));
+			runLength_Local >>= 7;
+
+		} while (runLength_Local > 0);
+
+
+		if (compressedVertexColors_Local.usesPalette) {
+
+			encodedRuns_Local.Add(paletteIndices_Local.FindChecked(vertexColors[runStart_Local].DWColor()));
+		}
+
+		else {
+
+			const FColor& runColor_Local = vertexColors[runStart_Local];
+			encodedRuns_Local.Append({ runColor_Local.B, runColor_Local.G, runColor_Local.R, runColor_Local.A });
+		}
+
+		runStart_Local = runEnd_Local;
+	}
+
+	encodedRuns_Local.Shrink();
+
+	return compressedVertexColors_Local;
+}
+
+
+//-------------------------------------------------------
+
+// Decompress
+
+void FCompressedVertexColors::Decompress(TArray<FColor>& vertexColors) const {
+
+	vertexColors.SetNumUninitialized(amountOfVertices);
+
+	const uint8* encodedRun_Local = encodedRuns.GetData();
+	const uint8* encodedRunsEnd_Local = encodedRun_Local + encodedRuns.Num();
+	int32 vertexIndex_Local = 0;
+
+	while (encodedRun_Local < encodedRunsEnd_Local && vertexIndex_Local < amountOfVertices) {
+
+		uint32 runLength_Local = 0;
+		uint32 shift_Local = 0;
+
+		while (encodedRun_Local < encodedRunsEnd_Local) {
+
+			const uint8 varintByte_Local = *encodedRun_Local++;
+			runLength_Local |= static_cast<uint32>(varintByte_Local & 0x7F) << shift_Local;
+			shift_Local += 7;
+
+			if ((varintByte_Local & 0x80) == 0) break;
+		}
+
+
+		FColor runColor_Local;
+
+		if (usesPalette) {
+
+			runColor_Local = palette[*encodedRun_Local++];
+		}
+
+		else {
+
+			runColor_Local = FColor(encodedRun_Local[2], encodedRun_Local[1], encodedRun_Local[0], encodedRun_Local[3]);
+			encodedRun_Local += 4;
+		}
+
+
+		const int32 runEnd_Local = FMath::Min(amountOfVertices, vertexIndex_Local + static_cast<int32>(runLength_Local));
+
+		for (; vertexIndex_Local < runEnd_Local; vertexIndex_Local++)
+			vertexColors[vertexIndex_Local] = runColor_Local;
+	}
+}
+
+
+//-------------------------------------------------------
+
+// Get
+
+FVertexColorsColdStorage& FVertexColorsColdStorage::Get() {
+
+	static FVertexColorsColdStorage vertexColorsColdStorage;
+	return vertexColorsColdStorage;
+}
+
+
+//-------------------------------------------------------
+
+// Mark Used
+
+void FVertexColorsColdStorage::MarkUsed(const UPrimitiveComponent* meshComponent) {
+
+#if ENGINE_MAJOR_VERSION == 5
+
+	// Only static meshes override buffers can be swapped for GPU only ones
+	if (!Cast<UStaticMeshComponent>(meshComponent)) return;
+	if (CVarVertexPaintColdStorageIdleSeconds.GetValueOnAnyThread() <= 0) return;
+
+
+	FScopeLock scopeLock_Local(&coldStorageCriticalSection);
+
+	coldStorageEntries.FindOrAdd(meshComponent).lastUsedTime = FPlatformTime::Seconds();
+
+	// Starts ticking the first time there's something to keep track of. The ticker runs on the Game Thread. 
+	if (!tickerHandle.IsValid())
+		tickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FVertexColorsColdStorage::Tick), 1.0f);
+
+#endif
+}
+
+
+//-------------------------------------------------------
+
+// Is Cold
+
+bool FVertexColorsColdStorage::IsCold(const UPrimitiveComponent* meshComponent) const {
+
+	FScopeLock scopeLock_Local(&coldStorageCriticalSection);
+
+	const FColdStorageEntry* coldStorageEntry_Local = coldStorageEntries.Find(meshComponent);
+
+	return coldStorageEntry_Local && IsEntryStillCold(meshComponent, *coldStorageEntry_Local);
+}
+
+
+//-------------------------------------------------------
+
+// Is Entry Still Cold
+
+bool FVertexColorsColdStorage::IsEntryStillCold(const UPrimitiveComponent* meshComponent, const FColdStorageEntry& coldStorageEntry) {
+
+	if (!coldStorageEntry.isCold) return false;
+
+	const UStaticMeshComponent* staticMeshComponent_Local = Cast<UStaticMeshComponent>(meshComponent);
+
+	if (!IsValid(staticMeshComponent_Local)) return false;
+	if (staticMeshComponent_Local->LODData.Num() != coldStorageEntry.coldOverrideVertexColors.Num()) return false;
+
+
+	for (int32 i = 0; i < coldStorageEntry.coldOverrideVertexColors.Num(); i++) {
+
+		if (coldStorageEntry.coldOverrideVertexColors[i] && staticMeshComponent_Local->LODData[i].OverrideVertexColors != coldStorageEntry.coldOverrideVertexColors[i])
+			return false;
+	}
+
+	return true;
+}
+
+
+//-------------------------------------------------------
+
+// Warm Up
+
+void FVertexColorsColdStorage::WarmUp(UPrimitiveComponent* meshComponent) {
+
+	if (!IsInGameThread()) return;
+
+	UStaticMeshComponent* staticMeshComponent_Local = Cast<UStaticMeshComponent>(meshComponent);
+
+	if (!IsValid(staticMeshComponent_Local)) return;
+
+
+	FScopeLock scopeLock_Local(&coldStorageCriticalSection);
+
+	FColdStorageEntry* coldStorageEntry_Local = coldStorageEntries.Find(staticMeshComponent_Local);
+
+	if (!coldStorageEntry_Local || !coldStorageEntry_Local->isCold) return;
+
+	// Has gotten new colors since it was compressed so they're already in CPU accessible buffers
+	if (!IsEntryStillCold(staticMeshComponent_Local, *coldStorageEntry_Local)) {
+
+		coldStorageEntry_Local->compressedColorsPerLOD.Empty();
+		coldStorageEntry_Local->sharedColorsPerLOD.Empty();
+		coldStorageEntry_Local->coldOverrideVertexColors.Empty();
+		coldStorageEntry_Local->isCold = false;
+		return;
+	}
+
+
+	TArray<TArray<FColor>> colorsPerLOD_Local;
+	colorsPerLOD_Local.SetNum(coldStorageEntry_Local->compressedColorsPerLOD.Num());
+
+	for (int32 i = 0; i < coldStorageEntry_Local->compressedColorsPerLOD.Num(); i++) {
+
+		if (coldStorageEntry_Local->compressedColorsPerLOD[i].IsSet())
+			coldStorageEntry_Local->compressedColorsPerLOD[i]->Decompress(colorsPerLOD_Local[i]);
+		else if (coldStorageEntry_Local->sharedColorsPerLOD.IsValidIndex(i) && coldStorageEntry_Local->sharedColorsPerLOD[i].IsValid())
+			colorsPerLOD_Local[i] = *coldStorageEntry_Local->sharedColorsPerLOD[i];
+	}
+
+	SwapOverrideVertexColors(staticMeshComponent_Local, colorsPerLOD_Local, true);
+
+	coldStorageEntry_Local->compressedColorsPerLOD.Empty();
+	coldStorageEntry_Local->sharedColorsPerLOD.Empty();
+	coldStorageEntry_Local->coldOverrideVertexColors.Empty();
+	coldStorageEntry_Local->isCold = false;
+	coldStorageEntry_Local->lastUsedTime = FPlatformTime::Seconds();
+}
+
+
+//-------------------------------------------------------
+
+// Get Cold Colors
+
+bool FVertexColorsColdStorage::GetColdColors(const UPrimitiveComponent* meshComponent, int32 lod, TArray<FColor>& vertexColors) const {
+
+	FScopeLock scopeLock_Local(&coldStorageCriticalSection);
+
+	const FColdStorageEntry* coldStorageEntry_Local = coldStorageEntries.Find(meshComponent);
+
+	if (!coldStorageEntry_Local || !IsEntryStillCold(meshComponent, *coldStorageEntry_Local)) return false;
+
+	if (coldStorageEntry_Local->sharedColorsPerLOD.IsValidIndex(lod) && coldStorageEntry_Local->sharedColorsPerLOD[lod].IsValid()) {
+
+		vertexColors = *coldStorageEntry_Local->sharedColorsPerLOD[lod];
+		return true;
+	}
+
+	if (!coldStorageEntry_Local->compressedColorsPerLOD.IsValidIndex(lod) || !coldStorageEntry_Local->compressedColorsPerLOD[lod].IsSet()) return false;
+
+	coldStorageEntry_Local->compressedColorsPerLOD[lod]->Decompress(vertexColors);
+
+	return true;
+}
+
+
+//-------------------------------------------------------
+
+// Get Cold Shared Colors
+
+FVertexColorsSnapshotPtr FVertexColorsColdStorage::GetColdSharedColors(const UPrimitiveComponent* meshComponent, int32 lod) const {
+
+	FScopeLock scopeLock_Local(&coldStorageCriticalSection);
+
+	const FColdStorageEntry* coldStorageEntry_Local = coldStorageEntries.Find(meshComponent);
+
+	if (!coldStorageEntry_Local || !IsEntryStillCold(meshComponent, *coldStorageEntry_Local)) return nullptr;
+	if (!coldStorageEntry_Local->sharedColorsPerLOD.IsValidIndex(lod)) return nullptr;
+
+	return coldStorageEntry_Local->sharedColorsPerLOD[lod];
+}
+
+
+//-------------------------------------------------------
+
+// Remove Component
+
+void FVertexColorsColdStorage::RemoveComponent(const UPrimitiveComponent* meshComponent) {
+
+	// If it's being removed because the mesh got swapped, its override buffers has already been replaced so the compressed colors are for the old mesh
+	const TWeakObjectPtr<const UPrimitiveComponent> meshComponentToRemove_Local = meshComponent;
+
+	FScopeLock scopeLock_Local(&coldStorageCriticalSection);
+
+	for (auto it = coldStorageEntries.CreateIterator(); it; ++it) {
+
+		if (it.Key() == meshComponentToRemove_Local)
+			it.RemoveCurrent();
+	}
+}
+
+
+//-------------------------------------------------------
+
+// Has Queued Tasks
+
+// Components are warmed up before their tasks are queued, so cooling one down again before they've run would have them read from a buffer without CPU data, or one that gets deleted on the Render Thread while they're still reading it. The amounts are cached per world since the queue builds a new map every time it's asked. 
+bool FVertexColorsColdStorage::HasQueuedTasks(UStaticMeshComponent* staticMeshComponent, TMap<UWorld*, FQueuedTasksOfWorld>& queuedTasksPerWorld) {
+
+	UWorld* world_Local = staticMeshComponent->GetWorld();
+
+	if (!world_Local) return false;
+
+
+	FQueuedTasksOfWorld* queuedTasksOfWorld_Local = queuedTasksPerWorld.Find(world_Local);
+
+	if (!queuedTasksOfWorld_Local) {
+
+		queuedTasksOfWorld_Local = &queuedTasksPerWorld.Add(world_Local);
+		queuedTasksOfWorld_Local->paintTasksAmount = VertexPaintFunctions::GetCalculateColorsPaintTasksAmount_Wrapper(staticMeshComponent);
+		queuedTasksOfWorld_Local->detectionTasksAmount = VertexPaintFunctions::GetCalculateColorsDetectionTasksAmount_Wrapper(staticMeshComponent);
+	}
+
+	return queuedTasksOfWorld_Local->paintTasksAmount.FindRef(staticMeshComponent) > 0 || queuedTasksOfWorld_Local->detectionTasksAmount.FindRef(staticMeshComponent) > 0;
+}
+
+
+//-------------------------------------------------------
+
+// Tick
+
+bool FVertexColorsColdStorage::Tick(float deltaTime) {
+
+	const float idleSeconds_Local = CVarVertexPaintColdStorageIdleSeconds.GetValueOnGameThread();
+	const int64 budgetBytes_Local = static_cast<int64>(CVarVertexPaintColdStorageBudgetMB.GetValueOnGameThread()) * 1024 * 1024;
+	const double currentTime_Local = FPlatformTime::Seconds();
+
+
+	FScopeLock scopeLock_Local(&coldStorageCriticalSection);
+
+	struct FWarmComponent {
+
+		UStaticMeshComponent* staticMeshComponent = nullptr;
+		FColdStorageEntry* coldStorageEntry = nullptr;
+		int64 cpuColorsSize = 0;
+	};
+
+	TArray<FWarmComponent> warmComponents_Local;
+	int64 totalCPUColorsSize_Local = 0;
+
+	TMap<UWorld*, FQueuedTasksOfWorld> queuedTasksPerWorld_Local;
+
+	for (auto it = coldStorageEntries.CreateIterator(); it; ++it) {
+
+		// The component may have been destroyed, in which case its buffers are gone with it
+		UStaticMeshComponent* staticMeshComponent_Local = const_cast<UStaticMeshComponent*>(Cast<UStaticMeshComponent>(it.Key().Get()));
+
+		if (!IsValid(staticMeshComponent_Local)) {
+
+			it.RemoveCurrent();
+			continue;
+		}
+
+		if (it.Value().isCold) {
+
+			if (IsEntryStillCold(staticMeshComponent_Local, it.Value())) continue;
+
+			// Got new colors since it was compressed, which means it's in use again
+			it.Value().compressedColorsPerLOD.Empty();
+			it.Value().sharedColorsPerLOD.Empty();
+			it.Value().coldOverrideVertexColors.Empty();
+			it.Value().isCold = false;
+			it.Value().lastUsedTime = currentTime_Local;
+			continue;
+		}
+
+
+		const int64 cpuColorsSize_Local = GetCPUColorsSize(staticMeshComponent_Local);
+		totalCPUColorsSize_Local += cpuColorsSize_Local;
+
+		// Still counts towards the budget, but can't be cooled down until its tasks has run
+		if (HasQueuedTasks(staticMeshComponent_Local, queuedTasksPerWorld_Local)) {
+
+			it.Value().lastUsedTime = currentTime_Local;
+			continue;
+		}
+
+		if (idleSeconds_Local > 0 && currentTime_Local - it.Value().lastUsedTime >= idleSeconds_Local) {
+
+			totalCPUColorsSize_Local -= cpuColorsSize_Local;
+
+			CoolDown(staticMeshComponent_Local, it.Value());
+			continue;
+		}
+
+		warmComponents_Local.Add({ staticMeshComponent_Local, &it.Value(), cpuColorsSize_Local });
+	}
+
+
+	// If we're still above the budget the least recently used gets compressed until we're not
+	if (budgetBytes_Local > 0 && totalCPUColorsSize_Local > budgetBytes_Local) {
+
+		warmComponents_Local.Sort([](const FWarmComponent& A, const FWarmComponent& B) {
+			return A.coldStorageEntry->lastUsedTime < B.coldStorageEntry->lastUsedTime;
+			});
+
+		for (const FWarmComponent& warmComponentTemp : warmComponents_Local) {
+
+			if (totalCPUColorsSize_Local <= budgetBytes_Local) break;
+
+			CoolDown(warmComponentTemp.staticMeshComponent, *warmComponentTemp.coldStorageEntry);
+			totalCPUColorsSize_Local -= warmComponentTemp.cpuColorsSize;
+		}
+	}
+
+	return true;
+}
+
+
+//-------------------------------------------------------
+
+// Cool Down
+
+void FVertexColorsColdStorage::CoolDown(UStaticMeshComponent* staticMeshComponent, FColdStorageEntry& coldStorageEntry) {
+
+#if ENGINE_MAJOR_VERSION == 5
+
+	bool hasAnyCPUColors_Local = false;
+
+	TArray<TArray<FColor>> colorsPerLOD_Local;
+	colorsPerLOD_Local.SetNum(staticMeshComponent->LODData.Num());
+
+	coldStorageEntry.compressedColorsPerLOD.Reset();
+	coldStorageEntry.compressedColorsPerLOD.SetNum(staticMeshComponent->LODData.Num());
+	coldStorageEntry.sharedColorsPerLOD.Reset();
+	coldStorageEntry.sharedColorsPerLOD.SetNum(staticMeshComponent->LODData.Num());
+
+	for (int32 i = 0; i < staticMeshComponent->LODData.Num(); i++) {
+
+		FColorVertexBuffer* overrideVertexColors_Local = staticMeshComponent->LODData[i].OverrideVertexColors;
+
+		if (!overrideVertexColors_Local || !overrideVertexColors_Local->GetVertexData() || overrideVertexColors_Local->GetNumVertices() <= 0) continue;
+
+		overrideVertexColors_Local->GetVertexColors(colorsPerLOD_Local[i]);
+		hasAnyCPUColors_Local = true;
+
+		// If a snapshot with the exact same colors is alive it already costs the memory, so we just hold on to it as well, which also makes the components next snapshot at this generation that same one
+		coldStorageEntry.sharedColorsPerLOD[i] = FVertexColorsSnapshotDedupCache::Get().FindSharedComponentColors(staticMeshComponent, staticMeshComponent->GetStaticMesh(), i, colorsPerLOD_Local[i], FVertexColorsGenerations::Get().GetGeneration(staticMeshComponent, i));
+
+		if (!coldStorageEntry.sharedColorsPerLOD[i].IsValid())
+			coldStorageEntry.compressedColorsPerLOD[i] = FCompressedVertexColors::Compress(colorsPerLOD_Local[i]);
+	}
+
+	// Nothing painted to compress
+	if (!hasAnyCPUColors_Local) {
+
+		coldStorageEntry.compressedColorsPerLOD.Empty();
+		coldStorageEntry.sharedColorsPerLOD.Empty();
+		return;
+	}
+
+	SwapOverrideVertexColors(staticMeshComponent, colorsPerLOD_Local, false, &coldStorageEntry.coldOverrideVertexColors);
+
+	coldStorageEntry.isCold = true;
+
+#endif
+}
+
+
+//-------------------------------------------------------
+
+// Get CPU Colors Size
+
+int64 FVertexColorsColdStorage::GetCPUColorsSize(const UStaticMeshComponent* staticMeshComponent) {
+
+	int64 cpuColorsSize_Local = 0;
+
+	for (const FStaticMeshComponentLODInfo& lodInfoTemp : staticMeshComponent->LODData) {
+
+		if (lodInfoTemp.OverrideVertexColors && lodInfoTemp.OverrideVertexColors->GetVertexData())
+			cpuColorsSize_Local += static_cast<int64>(lodInfoTemp.OverrideVertexColors->GetNumVertices()) * sizeof(FColor);
+	}
+
+	return cpuColorsSize_Local;
+}
+
+
+//-------------------------------------------------------
+
+// Swap Override Vertex Colors
+
+void FVertexColorsColdStorage::SwapOverrideVertexColors(UStaticMeshComponent* staticMeshComponent, const TArray<TArray<FColor>>& colorsPerLOD, bool needsCPUAccess, TArray<const FColorVertexBuffer*, TInlineAllocator<4>>* swappedInOverrideVertexColors) {
+
+#if ENGINE_MAJOR_VERSION == 5
+
+	TArray<FColorVertexBuffer*> previousOverrideVertexColors_Local;
+
+	if (swappedInOverrideVertexColors) {
+
+		swappedInOverrideVertexColors->Reset();
+		swappedInOverrideVertexColors->SetNumZeroed(staticMeshComponent->LODData.Num());
+	}
+
+	{
+		// Destroys the render state before the buffers are swapped and recreates it when going out of scope, so the proxy never points to a buffer that has been released
+		FComponentRecreateRenderStateContext recreateRenderStateContext_Local(staticMeshComponent);
+
+		for (int32 i = 0; i < colorsPerLOD.Num() && i < staticMeshComponent->LODData.Num(); i++) {
+
+			if (colorsPerLOD[i].Num() <= 0) continue;
+
+
+			// Without CPU access the RHI discards the CPU copy once it's been uploaded, which is the memory we're after
+			FColorVertexBuffer* newOverrideVertexColors_Local = new FColorVertexBuffer();
+			newOverrideVertexColors_Local->InitFromColorArray(colorsPerLOD[i].GetData(), colorsPerLOD[i].Num(), sizeof(FColor), needsCPUAccess);
+			BeginInitResource(newOverrideVertexColors_Local);
+
+			if (staticMeshComponent->LODData[i].OverrideVertexColors)
+				previousOverrideVertexColors_Local.Add(staticMeshComponent->LODData[i].OverrideVertexColors);
+
+			staticMeshComponent->LODData[i].OverrideVertexColors = newOverrideVertexColors_Local;
+
+			if (swappedInOverrideVertexColors)
+				(*swappedInOverrideVertexColors)[i] = newOverrideVertexColors_Local;
+		}
+	}
+
+
+	// Released and deleted on the Render Thread after the proxies that used them are gone
+	for (FColorVertexBuffer* previousOverrideVertexColorsTemp : previousOverrideVertexColors_Local) {
+
+		BeginReleaseResource(previousOverrideVertexColorsTemp);
+
+		ENQUEUE_RENDER_COMMAND(VertexPaintDeletePreviousOverrideVertexColors)([previousOverrideVertexColorsTemp](FRHICommandListImmediate& RHICmdList) {
+
+			delete previousOverrideVertexColorsTemp;
+		});
+	}
+
+#endif
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+#include "Containers/Ticker.h"
+#include "VertexColorsSnapshot.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+class UPrimitiveComponent;
+class UStaticMeshComponent;
+class UWorld;
+class FColorVertexBuffer;
+
+
+//-------------------------------------------------------
+
+// Compressed Vertex Colors
+
+// Painted meshes usually have large areas with the exact same color, so the colors are stored as runs of the same color. If there are 256 or fewer distinct colors each run only stores a byte index into a palette instead of the whole color. 
+
+struct FCompressedVertexColors {
+
+	static FCompressedVertexColors Compress(TConstArrayView<FColor> vertexColors);
+
+	void Decompress(TArray<FColor>& vertexColors) const;
+
+	int32 GetAmountOfVertices() const { return amountOfVertices; }
+
+	int64 GetAllocatedSize() const { return palette.GetAllocatedSize() + encodedRuns.GetAllocatedSize(); }
+
+
+private:
+
+	int32 amountOfVertices = 0;
+	bool usesPalette = false;
+
+	TArray<FColor> palette;
+
+	// Each run is its length as a varint followed by either the palette index or the whole color
+	TArray<uint8> encodedRuns;
+};
+
+
+//-------------------------------------------------------
+
+// Vertex Colors Cold Storage
+
+// Painted static meshes that no one has read from or painted on for a while gets the CPU side copy of their Override Vertex Colors compressed, and their override buffers replaced with ones that only lives on the GPU, so the full resolution colors doesn't sit in memory for every LOD of every painted prop for the whole session. They're decompressed back into a normal buffer the next time something reads or paints on the component, so nothing else has to know about it. 
+// Components also gets compressed early, least recently used first, if the CPU side colors of all the ones we track goes above the memory budget. 
+// LODs whose colors are identical to a Vertex Colors Snapshot that is alive in the Snapshot Dedup Cache, e.g. props that got the same color snippet and has been snapshotted, aren't compressed but holds on to that snapshot, so all of them share the one array. 
+
+class FVertexColorsColdStorage {
+
+public:
+
+	static FVertexColorsColdStorage& Get();
+
+	// Called whenever the colors of a component is read or painted, so we know it's in use. Safe to call from any thread. 
+	void MarkUsed(const UPrimitiveComponent* meshComponent);
+
+	bool IsCold(const UPrimitiveComponent* meshComponent) const;
+
+	// Decompresses the component's colors back into normal override buffers if they're compressed. Only on the Game Thread since it recreates the render state. 
+	void WarmUp(UPrimitiveComponent* meshComponent);
+
+	// For reads that aren't on the Game Thread and can't Warm Up the component, gets the colors at the LOD straight from the compressed data. Returns false if the component isn't cold. 
+	bool GetColdColors(const UPrimitiveComponent* meshComponent, int32 lod, TArray<FColor>& vertexColors) const;
+
+	// If the component is cold and its colors at the LOD are shared with a snapshot, reads can point straight into it on any thread without warming the component up or copying anything
+	FVertexColorsSnapshotPtr GetColdSharedColors(const UPrimitiveComponent* meshComponent, int32 lod) const;
+
+	void RemoveComponent(const UPrimitiveComponent* meshComponent);
+
+
+private:
+
+	struct FColdStorageEntry {
+
+		double lastUsedTime = 0;
+		bool isCold = false;
+
+		// One per LOD, only set while cold. LODs without override colors are left empty. 
+		TArray<TOptional<FCompressedVertexColors>, TInlineAllocator<4>> compressedColorsPerLOD;
+
+		// One per LOD, only set while cold, for the LODs that shares a snapshot's colors instead of being compressed
+		TArray<FVertexColorsSnapshotPtr, TInlineAllocator<4>> sharedColorsPerLOD;
+
+		// The GPU only buffers we swapped in. If the component no longer uses them, e.g. because paint got applied or colors got set, the compressed colors are outdated. 
+		TArray<const FColorVertexBuffer*, TInlineAllocator<4>> coldOverrideVertexColors;
+	};
+
+	static bool IsEntryStillCold(const UPrimitiveComponent* meshComponent, const FColdStorageEntry& coldStorageEntry);
+
+	struct FQueuedTasksOfWorld {
+
+		TMap<UPrimitiveComponent*, int> paintTasksAmount;
+		TMap<UPrimitiveComponent*, int> detectionTasksAmount;
+	};
+
+	static bool HasQueuedTasks(UStaticMeshComponent* staticMeshComponent, TMap<UWorld*, FQueuedTasksOfWorld>& queuedTasksPerWorld);
+
+	bool Tick(float deltaTime);
+
+	void CoolDown(UStaticMeshComponent* staticMeshComponent, FColdStorageEntry& coldStorageEntry);
+
+	static int64 GetCPUColorsSize(const UStaticMeshComponent* staticMeshComponent);
+
+	static void SwapOverrideVertexColors(UStaticMeshComponent* staticMeshComponent, const TArray<TArray<FColor>>& colorsPerLOD, bool needsCPUAccess, TArray<const FColorVertexBuffer*, TInlineAllocator<4>>* swappedInOverrideVertexColors = nullptr);
+
+
+	mutable FCriticalSection coldStorageCriticalSection;
+
+	TMap<TWeakObjectPtr<const UPrimitiveComponent>, FColdStorageEntry> coldStorageEntries;
+
+#if ENGINE_MAJOR_VERSION == 5
+	FTSTicker::FDelegateHandle tickerHandle;
+#endif
+};
@@ -0,0 +1,155 @@
+#include "VertexColorsGenerations.h"
+#include "Components/PrimitiveComponent.h"
+
+#if ENGINE_MAJOR_VERSION == 5
+#include "Components/DynamicMeshComponent.h"
+#include "UDynamicMesh.h"
+#endif
+
+
+//-------------------------------------------------------
+
+// Get
+
+FVertexColorsGenerations& FVertexColorsGenerations::Get() {
+
+	static FVertexColorsGenerations vertexColorsGenerations;
+	return vertexColorsGenerations;
+}
+
+
+//-------------------------------------------------------
+
+// Get Generation
+
+uint64 FVertexColorsGenerations::GetGeneration(const UPrimitiveComponent* meshComponent, int32 lod) const {
+
+	if (!IsValid(meshComponent)) return 0;
+	if (lod < 0) return 0;
+
+
+	FScopeLock scopeLock_Local(&generationsCriticalSection);
+
+	const FComponentGenerations* componentGenerations_Local = generationsPerComponent.Find(meshComponent);
+
+	if (!componentGenerations_Local) return 0;
+
+	if (componentGenerations_Local->generationPerLOD.IsValidIndex(lod))
+		return FMath::Max(componentGenerations_Local->allLODsGeneration, componentGenerations_Local->generationPerLOD[lod]);
+
+	return componentGenerations_Local->allLODsGeneration;
+}
+
+
+//-------------------------------------------------------
+
+// Bump Generation
+
+FVertexColorsGenerationBump FVertexColorsGenerations::BumpGeneration(const UPrimitiveComponent* meshComponent, int32 lod) {
+
+	FVertexColorsGenerationBump generationBump_Local;
+
+	if (!IsValid(meshComponent)) return generationBump_Local;
+	if (lod < 0) return generationBump_Local;
+
+
+	FScopeLock scopeLock_Local(&generationsCriticalSection);
+
+	RemoveDestroyedComponents();
+
+	FComponentGenerations& componentGenerations_Local = generationsPerComponent.FindOrAdd(meshComponent);
+
+	if (!componentGenerations_Local.generationPerLOD.IsValidIndex(lod))
+		componentGenerations_Local.generationPerLOD.SetNumZeroed(lod + 1);
+
+	// Same as Get Generation, but under the lock we bump with
+	generationBump_Local.previousGeneration = FMath::Max(componentGenerations_Local.allLODsGeneration, componentGenerations_Local.generationPerLOD[lod]);
+
+	componentGenerations_Local.generationPerLOD[lod] = ++lastGeneration;
+	generationBump_Local.newGeneration = lastGeneration;
+
+	return generationBump_Local;
+}
+
+uint64 FVertexColorsGenerations::BumpGenerationOfAllLODs(const UPrimitiveComponent* meshComponent) {
+
+	if (!IsValid(meshComponent)) return 0;
+
+
+	FScopeLock scopeLock_Local(&generationsCriticalSection);
+
+	RemoveDestroyedComponents();
+
+	generationsPerComponent.FindOrAdd(meshComponent).allLODsGeneration = ++lastGeneration;
+
+	return lastGeneration;
+}
+
+
+//-------------------------------------------------------
+
+// Watch Dynamic Mesh Component
+
+#if ENGINE_MAJOR_VERSION == 5
+
+void FVertexColorsGenerations::WatchDynamicMeshComponent(UDynamicMeshComponent* dynamicMeshComponent) {
+
+	if (!IsInGameThread()) return;
+	if (!IsValid(dynamicMeshComponent)) return;
+
+	UDynamicMesh* dynamicMesh_Local = dynamicMeshComponent->GetDynamicMesh();
+
+	if (!IsValid(dynamicMesh_Local)) return;
+
+
+	FWatchedDynamicMesh& watchedDynamicMesh_Local = watchedDynamicMeshes.FindOrAdd(dynamicMeshComponent);
+
+	if (watchedDynamicMesh_Local.dynamicMesh == dynamicMesh_Local && watchedDynamicMesh_Local.onMeshChangedHandle.IsValid()) return;
+
+	// Got another mesh since we started watching it
+	if (UDynamicMesh* previousDynamicMesh_Local = watchedDynamicMesh_Local.dynamicMesh.Get())
+		previousDynamicMesh_Local->OnMeshChanged().Remove(watchedDynamicMesh_Local.onMeshChangedHandle);
+
+
+	const TWeakObjectPtr<UDynamicMeshComponent> dynamicMeshComponentWeak_Local = dynamicMeshComponent;
+
+	watchedDynamicMesh_Local.dynamicMesh = dynamicMesh_Local;
+	watchedDynamicMesh_Local.onMeshChangedHandle = dynamicMesh_Local->OnMeshChanged().AddLambda([dynamicMeshComponentWeak_Local](UDynamicMesh* changedDynamicMesh, FDynamicMeshChangeInfo changeInfo) {
+
+		// The mesh can be shared with another component, or outlive this one
+		if (dynamicMeshComponentWeak_Local.IsValid())
+			FVertexColorsGenerations::Get().BumpGenerationOfAllLODs(dynamicMeshComponentWeak_Local.Get());
+		});
+
+	// Clears out the ones for components that has been destroyed, unbinding from their meshes if those are still around
+	for (auto it = watchedDynamicMeshes.CreateIterator(); it; ++it) {
+
+		if (it.Key().IsValid()) continue;
+
+		if (UDynamicMesh* watchedMesh_Local = it.Value().dynamicMesh.Get())
+			watchedMesh_Local->OnMeshChanged().Remove(it.Value().onMeshChangedHandle);
+
+		it.RemoveCurrent();
+	}
+}
+
+#endif
+
+
+//-------------------------------------------------------
+
+// Remove Destroyed Components
+
+void FVertexColorsGenerations::RemoveDestroyedComponents() {
+
+	// Only every now and then since bumps happen every time paint is applied
+	if (++amountOfBumpsSinceRemovingDestroyed < 256) return;
+
+	amountOfBumpsSinceRemovingDestroyed = 0;
+
+	for (auto it = generationsPerComponent.CreateIterator(); it; ++it) {
+
+		if (!it.Key().IsValid())
+			it.RemoveCurrent();
+	}
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+class UPrimitiveComponent;
+class UDynamicMeshComponent;
+class UDynamicMesh;
+
+
+//-------------------------------------------------------
+
+// Vertex Colors Generation Bump
+
+// The generation from right before a bump and the one it was bumped to, taken under the same lock so nothing else can bump in between
+
+struct FVertexColorsGenerationBump {
+
+	uint64 previousGeneration = 0;
+	uint64 newGeneration = 0;
+};
+
+
+//-------------------------------------------------------
+
+// Vertex Colors Generations
+
+// A number for each component and LOD that only ever goes up, and is bumped whenever its colors change, i.e. when a paint task applies colors, when colors are Set directly, when the mesh is swapped, or when a watched Dynamic Mesh changes. So anything that reads colors or computes something from them can store the generation with its result and keep using it for as long as the generation is the same, instead of reading the colors again. 
+// Components that has never had their colors changed are at generation 0. 
+
+class FVertexColorsGenerations {
+
+public:
+
+	static FVertexColorsGenerations& Get();
+
+	uint64 GetGeneration(const UPrimitiveComponent* meshComponent, int32 lod) const;
+
+	FVertexColorsGenerationBump BumpGeneration(const UPrimitiveComponent* meshComponent, int32 lod);
+
+	// For when every LOD changes at once, e.g. when the mesh gets swapped. Returns the new generation. 
+	uint64 BumpGenerationOfAllLODs(const UPrimitiveComponent* meshComponent);
+
+#if ENGINE_MAJOR_VERSION == 5
+
+	// Dynamic Meshes can be edited by anything, e.g. Geometry Script, without going through us, so the component's generation gets bumped from its meshes On Mesh Changed as well. Run when its colors are read on the Game Thread, since that is where the event is bound and broadcast, and rebinds if the component has gotten another mesh since. 
+	void WatchDynamicMeshComponent(UDynamicMeshComponent* dynamicMeshComponent);
+
+#endif
+
+
+private:
+
+	struct FComponentGenerations {
+
+		uint64 allLODsGeneration = 0;
+		TArray<uint64, TInlineAllocator<4>> generationPerLOD;
+	};
+
+	void RemoveDestroyedComponents();
+
+
+	mutable FCriticalSection generationsCriticalSection;
+
+	TMap<TWeakObjectPtr<const UPrimitiveComponent>, FComponentGenerations> generationsPerComponent;
+
+#if ENGINE_MAJOR_VERSION == 5
+
+	struct FWatchedDynamicMesh {
+
+		TWeakObjectPtr<UDynamicMesh> dynamicMesh;
+		FDelegateHandle onMeshChangedHandle;
+	};
+
+	// Only touched on the Game Thread
+	TMap<TWeakObjectPtr<UDynamicMeshComponent>, FWatchedDynamicMesh> watchedDynamicMeshes;
+
+#endif
+
+	// Every bump takes the next number from this, so a component's generation is the highest of its all LODs and LOD specific ones and still only ever goes up
+	uint64 lastGeneration = 0;
+
+	int32 amountOfBumpsSinceRemovingDestroyed = 0;
+};
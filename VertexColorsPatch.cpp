@@ -0,0 +1,228 @@
+#include "VertexColorsPatch.h"
+#include "Hash/CityHash.h"
+
+
+//-------------------------------------------------------
+
+// Varints
+
+static void WriteVertexColorsPatchVarint(TArray<uint8>& patch, uint32 value) {
+
+	do {
+
+		patch.Add(static_cast<uint8>((value & 0x7F) | (value > 0x7F ? 0x80 : 0)));
+		value >>= 7;
+
+	} while (value > 0);
+}
+
+static bool ReadVertexColorsPatchVarint(const uint8*& patchPosition, const uint8* patchEnd, uint32& value) {
+
+	value = 0;
+
+	// At most 5 bytes for a uint32
+	for (uint32 shift_Local = 0; shift_Local < 35 && patchPosition < patchEnd; shift_Local += 7) {
+
+		const uint8 varintByte_Local = *patchPosition++;
+		value |= static_cast<uint32>(varintByte_Local & 0x7F) << shift_Local;
+
+		if ((varintByte_Local & 0x80) == 0) return true;
+	}
+
+	return false;
+}
+
+
+//-------------------------------------------------------
+
+// Serialize Header
+
+static void WriteVertexColorsPatchHeader(TArray<uint8>& patch, const FVertexColorsPatchHeader& header) {
+
+	patch.SetNumUninitialized(FVertexColorsPatchHeader::SerializedSize);
+
+	uint8* headerBytes_Local = patch.GetData();
+	FMemory::Memcpy(headerBytes_Local, &header.magic, 4);
+	FMemory::Memcpy(headerBytes_Local + 4, &header.version, 2);
+	FMemory::Memcpy(headerBytes_Local + 6, &header.amountOfVertices, 4);
+	FMemory::Memcpy(headerBytes_Local + 10, &header.amountOfChangedVertices, 4);
+	FMemory::Memcpy(headerBytes_Local + 14, &header.baseColorsHash, 8);
+}
+
+bool FVertexColorsPatch::ReadHeader(TConstArrayView<uint8> patch, FVertexColorsPatchHeader& header) {
+
+	if (patch.Num() < FVertexColorsPatchHeader::SerializedSizeVersion1) return false;
+
+
+	const uint8* headerBytes_Local = patch.GetData();
+	FMemory::Memcpy(&header.magic, headerBytes_Local, 4);
+	FMemory::Memcpy(&header.version, headerBytes_Local + 4, 2);
+	FMemory::Memcpy(&header.amountOfVertices, headerBytes_Local + 6, 4);
+	FMemory::Memcpy(&header.amountOfChangedVertices, headerBytes_Local + 10, 4);
+
+	if (header.magic != FVertexColorsPatchHeader::Magic) return false;
+	if (header.version == 0 || header.version > FVertexColorsPatchHeader::CurrentVersion) return false;
+	if (patch.Num() < FVertexColorsPatchHeader::GetSerializedSize(header.version)) return false;
+
+	header.baseColorsHash = 0;
+
+	if (header.version >= 2)
+		FMemory::Memcpy(&header.baseColorsHash, headerBytes_Local + 14, 8);
+
+	if (header.amountOfVertices < 0 || header.amountOfChangedVertices < 0 || header.amountOfChangedVertices > header.amountOfVertices) return false;
+
+	return true;
+}
+
+
+//-------------------------------------------------------
+
+// Compute
+
+bool FVertexColorsPatch::Compute(TConstArrayView<FColor> fromColors, TConstArrayView<FColor> toColors, TArray<uint8>& patch) {
+
+	patch.Reset();
+
+	if (fromColors.Num() != toColors.Num()) return false;
+
+
+	FVertexColorsPatchHeader header_Local;
+	header_Local.amountOfVertices = toColors.Num();
+	header_Local.baseColorsHash = CityHash64(reinterpret_cast<const char*>(fromColors.GetData()), fromColors.Num() * sizeof(FColor));
+
+	WriteVertexColorsPatchHeader(patch, header_Local);
+
+
+	const int32 amountOfVertices_Local = toColors.Num();
+	const FColor* fromColorsData_Local = fromColors.GetData();
+	const FColor* toColorsData_Local = toColors.GetData();
+
+	// Equal blocks are skipped with memcmp, which is vectorized, so mostly unchanged arrays are only compared a cache line at a time
+	const int32 verticesPerBlock_Local = 16;
+
+	int32 vertexIndex_Local = 0;
+	int32 endOfPreviousSpan_Local = 0;
+
+	while (vertexIndex_Local < amountOfVertices_Local) {
+
+		while (vertexIndex_Local + verticesPerBlock_Local <= amountOfVertices_Local && FMemory::Memcmp(fromColorsData_Local + vertexIndex_Local, toColorsData_Local + vertexIndex_Local, verticesPerBlock_Local * sizeof(FColor)) == 0)
+			vertexIndex_Local += verticesPerBlock_Local;
+
+		while (vertexIndex_Local < amountOfVertices_Local && fromColorsData_Local[vertexIndex_Local] == toColorsData_Local[vertexIndex_Local])
+			vertexIndex_Local++;
+
+		if (vertexIndex_Local >= amountOfVertices_Local) break;
+
+
+		// Found a changed vertex, so the span goes until the next one that is the same in both
+		const int32 spanStart_Local = vertexIndex_Local;
+
+		while (vertexIndex_Local < amountOfVertices_Local && fromColorsData_Local[vertexIndex_Local] != toColorsData_Local[vertexIndex_Local])
+			vertexIndex_Local++;
+
+		const int32 spanEnd_Local = vertexIndex_Local;
+
+		WriteVertexColorsPatchVarint(patch, static_cast<uint32>(spanStart_Local - endOfPreviousSpan_Local));
+		WriteVertexColorsPatchVarint(patch, static_cast<uint32>(spanEnd_Local - spanStart_Local));
+
+
+		// The new colors of the span as runs of the same color
+		int32 runStart_Local = spanStart_Local;
+
+		while (runStart_Local < spanEnd_Local) {
+
+			int32 runEnd_Local = runStart_Local + 1;
+
+			while (runEnd_Local < spanEnd_Local && toColorsData_Local[runEnd_Local] == toColorsData_Local[runStart_Local])
+				runEnd_Local++;
+
+			const FColor& runColor_Local = toColorsData_Local[runStart_Local];
+
+			WriteVertexColorsPatchVarint(patch, static_cast<uint32>(runEnd_Local - runStart_Local));
+			patch.Append({ runColor_Local.B, runColor_Local.G, runColor_Local.R, runColor_Local.A });
+
+			runStart_Local = runEnd_Local;
+		}
+
+		header_Local.amountOfChangedVertices += spanEnd_Local - spanStart_Local;
+		endOfPreviousSpan_Local = spanEnd_Local;
+	}
+
+
+	// Rewrites the header now that we know how many changed
+	FMemory::Memcpy(patch.GetData() + 10, &header_Local.amountOfChangedVertices, 4);
+
+	return true;
+}
+
+
+//-------------------------------------------------------
+
+// Apply
+
+bool FVertexColorsPatch::Apply(TArrayView<FColor> vertexColors, TConstArrayView<uint8> patch) {
+
+	FVertexColorsPatchHeader header_Local;
+
+	if (!ReadHeader(patch, header_Local)) return false;
+	if (header_Local.amountOfVertices != vertexColors.Num()) return false;
+
+	// If the colors aren't the ones the patch was made from, e.g. because other paint got applied in between, patching them would leave them as neither
+	if (header_Local.version >= 2 && CityHash64(reinterpret_cast<const char*>(vertexColors.GetData()), vertexColors.Num() * sizeof(FColor)) != header_Local.baseColorsHash) return false;
+
+
+	const uint8* patchStart_Local = patch.GetData() + FVertexColorsPatchHeader::GetSerializedSize(header_Local.version);
+	const uint8* patchEnd_Local = patch.GetData() + patch.Num();
+
+	// Validates the whole patch before writing anything, so a corrupt one can't leave the colors half patched. It's only a pass over the spans and not the vertices so it's cheap. 
+	for (int32 pass_Local = 0; pass_Local < 2; pass_Local++) {
+
+		const bool writeColors_Local = pass_Local == 1;
+		const uint8* patchPosition_Local = patchStart_Local;
+		int64 vertexIndex_Local = 0;
+		int64 amountOfChangedVertices_Local = 0;
+
+		while (patchPosition_Local < patchEnd_Local) {
+
+			uint32 amountToSkip_Local = 0;
+			uint32 amountChanged_Local = 0;
+
+			if (!ReadVertexColorsPatchVarint(patchPosition_Local, patchEnd_Local, amountToSkip_Local)) return false;
+			if (!ReadVertexColorsPatchVarint(patchPosition_Local, patchEnd_Local, amountChanged_Local)) return false;
+
+			vertexIndex_Local += amountToSkip_Local;
+
+			if (amountChanged_Local == 0 || vertexIndex_Local + amountChanged_Local > vertexColors.Num()) return false;
+
+
+			const int64 spanEnd_Local = vertexIndex_Local + amountChanged_Local;
+			amountOfChangedVertices_Local += amountChanged_Local;
+
+			while (vertexIndex_Local < spanEnd_Local) {
+
+				uint32 runLength_Local = 0;
+
+				if (!ReadVertexColorsPatchVarint(patchPosition_Local, patchEnd_Local, runLength_Local)) return false;
+				if (runLength_Local == 0 || vertexIndex_Local + runLength_Local > spanEnd_Local) return false;
+				if (patchEnd_Local - patchPosition_Local < 4) return false;
+
+				if (writeColors_Local) {
+
+					const FColor runColor_Local(patchPosition_Local[2], patchPosition_Local[1], patchPosition_Local[0], patchPosition_Local[3]);
+					FColor* runStart_Local = vertexColors.GetData() + vertexIndex_Local;
+
+					for (uint32 i = 0; i < runLength_Local; i++)
+						runStart_Local[i] = runColor_Local;
+				}
+
+				patchPosition_Local += 4;
+				vertexIndex_Local += runLength_Local;
+			}
+		}
+
+		// The spans has to add up to what the header says changed, which catches patches that got cut off between two spans
+		if (amountOfChangedVertices_Local != header_Local.amountOfChangedVertices) return false;
+	}
+
+	return true;
+}
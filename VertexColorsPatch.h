@@ -0,0 +1,44 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+//-------------------------------------------------------
+
+// Vertex Colors Patch
+
+// The difference between two color arrays of the same mesh as only the vertices that changed, so incremental saves, undo and syncing between clients can send that instead of every color. 
+// The patch is a small header followed by spans. The header has a hash of the colors the patch was made from, so it can't be applied to any other colors with the same amount of vertices, which would leave them as a mix of both. Each span is how many vertices to skip, how many changed after that, and the new colors of the changed ones as runs of the same color, since paint usually sets many vertices next to each other to the same color. Counts are stored as varints so short spans only take a byte each. 
+
+struct FVertexColorsPatchHeader {
+
+	static const uint32 Magic = 0x48435056; // VPCH
+	static const uint16 CurrentVersion = 2;
+
+	uint32 magic = Magic;
+	uint16 version = CurrentVersion;
+	int32 amountOfVertices = 0;
+	int32 amountOfChangedVertices = 0;
+
+	// CityHash64 of the colors the patch was made from. Version 1 patches doesn't have it so they're applied to any colors with the right amount of vertices. 
+	uint64 baseColorsHash = 0;
+
+	static constexpr int32 SerializedSize = 4 + 2 + 4 + 4 + 8;
+	static constexpr int32 SerializedSizeVersion1 = 4 + 2 + 4 + 4;
+
+	static int32 GetSerializedSize(uint16 version) { return version == 1 ? SerializedSizeVersion1 : SerializedSize; }
+};
+
+
+class FVertexColorsPatch {
+
+public:
+
+	// Makes a patch that turns fromColors into toColors. Both has to have the same amount of vertices. 
+	static bool Compute(TConstArrayView<FColor> fromColors, TConstArrayView<FColor> toColors, TArray<uint8>& patch);
+
+	// Applies it in place. Fails without changing anything if the patch is for another amount of vertices, was made from other colors than these, or is corrupt. 
+	static bool Apply(TArrayView<FColor> vertexColors, TConstArrayView<uint8> patch);
+
+	static bool ReadHeader(TConstArrayView<uint8> patch, FVertexColorsPatchHeader& header);
+};
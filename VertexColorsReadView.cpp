@@ -0,0 +1,419 @@
+#include "VertexColorsReadView.h"
+#include "VertexPaintFunctionLibrary.h"
+#include "VertexColorsColdStorage.h"
+#include "VertexPaintSnapshot.h"
+#include "VertexColorsGenerations.h"
+#include "Engine/StaticMesh.h"
+#include "StaticMeshResources.h"
+#include "Components/StaticMeshComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Rendering/SkeletalMeshRenderData.h"
+#include "Rendering/ColorVertexBuffer.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+#if ENGINE_MAJOR_VERSION == 5
+#include "Components/DynamicMeshComponent.h"
+#include "GeometryCollection/GeometryCollectionComponent.h"
+#endif
+
+
+//-------------------------------------------------------
+
+// Create
+
+FVertexColorsReadView FVertexColorsReadView::Create(UPrimitiveComponent* meshComponent, int32 lod) {
+
+	FVertexColorsReadView readView_Local;
+
+	if (!::IsValid(meshComponent)) return readView_Local;
+
+
+	// If the component is in a snapshot that is being restored and hasn't gotten its colors yet they're restored now, so nothing that reads colors can get them from before the snapshot. The task that Sets them hasn't run yet, so for LOD0 the view holds the snapshot colors. The snapshot only has LOD0 and the task is what propagates it to the other LODs, so views of those has the colors from before the snapshot until it has run. Only on the Game Thread, which is what the restore runs on. 
+	if (IsInGameThread()) {
+
+		TArray<FColor> restoredColorsAtLOD0_Local;
+
+		if (FVertexPaintSnapshotRestore::Get().RestoreComponentIfPending(meshComponent, lod == 0 ? &restoredColorsAtLOD0_Local : nullptr) && lod == 0)
+			return CreateHoldingVertexColors(MoveTemp(restoredColorsAtLOD0_Local));
+	}
+
+
+	// Resolves the colors the same way as GetStaticMeshVertexColorsAtLOD and GetSkeletalMeshVertexColorsAtLOD has done, including what they fill with when there are no colors to get, so using the view gives the exact same colors as the copy
+	if (UStaticMeshComponent* staticMeshComponent = Cast<UStaticMeshComponent>(meshComponent)) {
+
+		if (lod < 0) return readView_Local;
+
+		UStaticMesh* staticMesh_Local = staticMeshComponent->GetStaticMesh();
+
+		if (!::IsValid(staticMesh_Local)) return readView_Local;
+		if (!staticMesh_Local->bAllowCPUAccess) return readView_Local;
+		if (!staticMesh_Local->GetRenderData() || !staticMesh_Local->GetRenderData()->LODResources.IsValidIndex(lod)) return readView_Local;
+
+
+		// If the colors has been compressed into cold storage the override buffers no longer has any CPU side data, so they're decompressed back into them if we can recreate the render state, or otherwise straight into the view
+		FVertexColorsColdStorage& vertexColorsColdStorage_Local = FVertexColorsColdStorage::Get();
+		vertexColorsColdStorage_Local.MarkUsed(meshComponent);
+
+		// Unless the LOD shares its colors with a snapshot, which the view can point into on any thread, so reading doesn't give it its own CPU copy back
+		if (FVertexColorsSnapshotPtr coldSharedColors_Local = vertexColorsColdStorage_Local.GetColdSharedColors(meshComponent, lod)) {
+
+			readView_Local.HoldVertexColorsSnapshot(coldSharedColors_Local.ToSharedRef());
+			return readView_Local;
+		}
+
+		if (vertexColorsColdStorage_Local.IsCold(meshComponent)) {
+
+			if (IsInGameThread()) {
+
+				vertexColorsColdStorage_Local.WarmUp(meshComponent);
+			}
+
+			else {
+
+				TArray<FColor> coldVertexColors_Local;
+
+				if (vertexColorsColdStorage_Local.GetColdColors(meshComponent, lod, coldVertexColors_Local)) {
+
+					readView_Local.HoldVertexColors(MoveTemp(coldVertexColors_Local));
+					return readView_Local;
+				}
+			}
+		}
+
+
+		FStaticMeshLODResources& lodResources_Local = staticMesh_Local->GetRenderData()->LODResources[lod];
+		const int32 meshLODTotalAmountOfVerts_Local = lodResources_Local.VertexBuffers.PositionVertexBuffer.GetNumVertices();
+		FColorVertexBuffer* colorVertexBuffer_Local = GetColorVertexBufferInUse(meshComponent, lod);
+
+		if (colorVertexBuffer_Local && colorVertexBuffer_Local->GetVertexData() && colorVertexBuffer_Local->GetNumVertices() > 0) {
+
+			readView_Local.ViewColorVertexBuffer(meshComponent, lod, colorVertexBuffer_Local);
+		}
+
+		else {
+
+			// If the component has LOD Data but no colors to get we've returned the array zeroed, otherwise if the color buffer isn't initialized it means it's default White and hasn't been painted. Either way they're all the same color so nothing has to be allocated unless someone asks for the array. 
+			if (staticMeshComponent->LODData.IsValidIndex(lod) || lodResources_Local.VertexBuffers.ColorVertexBuffer.IsInitialized())
+				readView_Local.HoldUniformColor(FColor(0, 0, 0, 0), meshLODTotalAmountOfVerts_Local);
+			else
+				readView_Local.HoldUniformColor(FColor::White, meshLODTotalAmountOfVerts_Local);
+		}
+	}
+
+	else if (USkeletalMeshComponent* skeletalMeshComponent = Cast<USkeletalMeshComponent>(meshComponent)) {
+
+		if (lod < 0) return readView_Local;
+		if (!skeletalMeshComponent->GetSkeletalMeshRenderData()) return readView_Local;
+
+
+		FColorVertexBuffer* colorVertexBuffer_Local = GetColorVertexBufferInUse(meshComponent, lod);
+
+		if (colorVertexBuffer_Local && colorVertexBuffer_Local->GetVertexData() && colorVertexBuffer_Local->GetNumVertices() > 0) {
+
+			readView_Local.ViewColorVertexBuffer(meshComponent, lod, colorVertexBuffer_Local);
+		}
+
+		// Same as GetSkeletalMeshVertexColorsAtLOD, meshes imported with all White that hasn't been painted can have no colors in their buffer
+		else if (skeletalMeshComponent->GetSkeletalMeshRenderData()->LODRenderData.IsValidIndex(lod)) {
+
+			readView_Local.HoldUniformColor(FColor::White, skeletalMeshComponent->GetSkeletalMeshRenderData()->LODRenderData[lod].GetNumVertices());
+		}
+	}
+
+#if ENGINE_MAJOR_VERSION == 5
+
+	// These doesn't store FColors we can point into so they're converted when read, into wherever the colors are going if that's known
+	else if (UDynamicMeshComponent* dynamicMeshComponent = Cast<UDynamicMeshComponent>(meshComponent)) {
+
+		// Whatever gets computed from these colors may get cached with the generation, so from now on edits to the mesh that doesn't go through us bumps it as well
+		FVertexColorsGenerations::Get().WatchDynamicMeshComponent(dynamicMeshComponent);
+
+		readView_Local.ConvertOnRead(dynamicMeshComponent, VertexPaintFunctions::GetDynamicMeshAmountOfVertexColors(dynamicMeshComponent));
+	}
+
+	else if (UGeometryCollectionComponent* geometryCollectionComponent = Cast<UGeometryCollectionComponent>(meshComponent)) {
+
+		readView_Local.ConvertOnRead(geometryCollectionComponent, VertexPaintFunctions::GetGeometryCollectionAmountOfVertexColors(geometryCollectionComponent));
+	}
+
+#endif
+
+	return readView_Local;
+}
+
+
+//-------------------------------------------------------
+
+// Create Holding Vertex Colors
+
+FVertexColorsReadView FVertexColorsReadView::CreateHoldingVertexColors(TArray<FColor>&& vertexColors) {
+
+	FVertexColorsReadView readView_Local;
+	readView_Local.HoldVertexColors(MoveTemp(vertexColors));
+
+	return readView_Local;
+}
+
+
+//-------------------------------------------------------
+
+// Get Color Vertex Buffer In Use
+
+FColorVertexBuffer* FVertexColorsReadView::GetColorVertexBufferInUse(UPrimitiveComponent* meshComponent, int32 lod) {
+
+	if (!::IsValid(meshComponent)) return nullptr;
+	if (lod < 0) return nullptr;
+
+
+	if (UStaticMeshComponent* staticMeshComponent = Cast<UStaticMeshComponent>(meshComponent)) {
+
+		if (staticMeshComponent->LODData.IsValidIndex(lod) && staticMeshComponent->LODData[lod].OverrideVertexColors)
+			return staticMeshComponent->LODData[lod].OverrideVertexColors;
+
+		if (!::IsValid(staticMeshComponent->GetStaticMesh())) return nullptr;
+		if (!staticMeshComponent->GetStaticMesh()->GetRenderData() || !staticMeshComponent->GetStaticMesh()->GetRenderData()->LODResources.IsValidIndex(lod)) return nullptr;
+
+		return &staticMeshComponent->GetStaticMesh()->GetRenderData()->LODResources[lod].VertexBuffers.ColorVertexBuffer;
+	}
+
+	else if (USkeletalMeshComponent* skeletalMeshComponent = Cast<USkeletalMeshComponent>(meshComponent)) {
+
+		if (skeletalMeshComponent->LODInfo.IsValidIndex(lod) && skeletalMeshComponent->LODInfo[lod].OverrideVertexColors)
+			return skeletalMeshComponent->LODInfo[lod].OverrideVertexColors;
+
+		if (!skeletalMeshComponent->GetSkeletalMeshRenderData() || !skeletalMeshComponent->GetSkeletalMeshRenderData()->LODRenderData.IsValidIndex(lod)) return nullptr;
+
+		return &skeletalMeshComponent->GetSkeletalMeshRenderData()->LODRenderData[lod].StaticVertexBuffers.ColorVertexBuffer;
+	}
+
+	return nullptr;
+}
+
+
+//-------------------------------------------------------
+
+// Is Valid
+
+bool FVertexColorsReadView::IsValid() const {
+
+	// Holds its own colors so can't become invalid
+	if (!viewedColorVertexBuffer) return true;
+
+	if (!viewedMeshComponent.IsValid()) return false;
+
+	// If paint got applied or the mesh switched since the view was created the component uses another buffer, and the one we point into may have been released
+	return GetColorVertexBufferInUse(viewedMeshComponent.Get(), viewedLOD) == viewedColorVertexBuffer;
+}
+
+
+//-------------------------------------------------------
+
+// To Array
+
+TArray<FColor> FVertexColorsReadView::ToArray() const {
+
+	if (isUniform) {
+
+		TArray<FColor> vertexColors_Local;
+		vertexColors_Local.Init(uniformColor, amountOfUniformVertices);
+
+		return vertexColors_Local;
+	}
+
+	if (convertOnRead) {
+
+		TArray<FColor> vertexColors_Local;
+		vertexColors_Local.SetNumUninitialized(amountOfVerticesToConvert);
+		ConvertVertexColorsInto(vertexColors_Local);
+
+		return vertexColors_Local;
+	}
+
+	return TArray<FColor>(viewedVertexColors.GetData(), viewedVertexColors.Num());
+}
+
+
+//-------------------------------------------------------
+
+// Copy To
+
+void FVertexColorsReadView::CopyTo(TArrayView<FColor> destination) const {
+
+	check(destination.Num() >= Num());
+
+	if (isUniform) {
+
+		for (int32 i = 0; i < amountOfUniformVertices; i++)
+			destination[i] = uniformColor;
+
+		return;
+	}
+
+	if (convertOnRead) {
+
+		ConvertVertexColorsInto(TArrayView<FColor>(destination.GetData(), amountOfVerticesToConvert));
+		return;
+	}
+
+	if (viewedVertexColors.Num() > 0)
+		FMemory::Memcpy(destination.GetData(), viewedVertexColors.GetData(), viewedVertexColors.Num() * sizeof(FColor));
+}
+
+
+//-------------------------------------------------------
+
+// Move To Array
+
+TArray<FColor> FVertexColorsReadView::MoveToArray() {
+
+	// This is where a Uniform or converted view gets its colors filled in if they haven't been, e.g. when a paint task needs them to paint on
+	ResolveColors();
+
+	TArray<FColor> vertexColors_Local = (viewedColorVertexBuffer || heldVertexColorsSnapshot.IsValid()) ? ToArray() : MoveTemp(heldVertexColors);
+
+	*this = FVertexColorsReadView();
+
+	return vertexColors_Local;
+}
+
+
+//-------------------------------------------------------
+
+// View Color Vertex Buffer
+
+void FVertexColorsReadView::ViewColorVertexBuffer(UPrimitiveComponent* meshComponent, int32 lod, FColorVertexBuffer* colorVertexBuffer) {
+
+	viewedMeshComponent = meshComponent;
+	viewedLOD = lod;
+	viewedColorVertexBuffer = colorVertexBuffer;
+
+	// The CPU side data is tightly packed FColors, the same that GetVertexColors copies out
+	viewedVertexColors = TConstArrayView<FColor>(static_cast<const FColor*>(colorVertexBuffer->GetVertexData()), colorVertexBuffer->GetNumVertices());
+}
+
+
+//-------------------------------------------------------
+
+// Hold Vertex Colors
+
+void FVertexColorsReadView::HoldVertexColors(TArray<FColor>&& vertexColors) {
+
+	viewedMeshComponent.Reset();
+	viewedColorVertexBuffer = nullptr;
+	heldVertexColorsSnapshot.Reset();
+	isUniform = false;
+	amountOfUniformVertices = 0;
+	convertOnRead = false;
+
+	heldVertexColors = MoveTemp(vertexColors);
+
+	// Moving a TArray keeps its heap allocation, so the view stays valid when the view itself gets moved
+	viewedVertexColors = heldVertexColors;
+}
+
+
+//-------------------------------------------------------
+
+// Hold Vertex Colors Snapshot
+
+void FVertexColorsReadView::HoldVertexColorsSnapshot(const FVertexColorsSnapshotRef& vertexColorsSnapshot) {
+
+	viewedMeshComponent.Reset();
+	viewedColorVertexBuffer = nullptr;
+	heldVertexColors.Empty();
+	isUniform = false;
+	amountOfUniformVertices = 0;
+	convertOnRead = false;
+
+	heldVertexColorsSnapshot = vertexColorsSnapshot;
+	viewedVertexColors = *vertexColorsSnapshot;
+}
+
+
+//-------------------------------------------------------
+
+// Hold Uniform Color
+
+void FVertexColorsReadView::HoldUniformColor(const FColor& color, int32 amountOfVertices) {
+
+	viewedMeshComponent.Reset();
+	viewedColorVertexBuffer = nullptr;
+	heldVertexColors.Empty();
+	heldVertexColorsSnapshot.Reset();
+	viewedVertexColors = TConstArrayView<FColor>();
+	convertOnRead = false;
+
+	isUniform = true;
+	uniformColor = color;
+	amountOfUniformVertices = FMath::Max(0, amountOfVertices);
+}
+
+
+//-------------------------------------------------------
+
+// Convert On Read
+
+void FVertexColorsReadView::ConvertOnRead(UPrimitiveComponent* meshComponent, int32 amountOfVertices) {
+
+	viewedMeshComponent.Reset();
+	viewedColorVertexBuffer = nullptr;
+	heldVertexColors.Empty();
+	heldVertexColorsSnapshot.Reset();
+	viewedVertexColors = TConstArrayView<FColor>();
+	isUniform = false;
+
+	convertOnRead = true;
+	meshComponentToConvert = meshComponent;
+	amountOfVerticesToConvert = FMath::Max(0, amountOfVertices);
+}
+
+
+//-------------------------------------------------------
+
+// Convert Vertex Colors Into
+
+void FVertexColorsReadView::ConvertVertexColorsInto(TArrayView<FColor> destination) const {
+
+#if ENGINE_MAJOR_VERSION == 5
+
+	if (UDynamicMeshComponent* dynamicMeshComponent = Cast<UDynamicMeshComponent>(meshComponentToConvert.Get())) {
+
+		VertexPaintFunctions::GetDynamicMeshVertexColors(dynamicMeshComponent, destination);
+		return;
+	}
+
+	if (UGeometryCollectionComponent* geometryCollectionComponent = Cast<UGeometryCollectionComponent>(meshComponentToConvert.Get())) {
+
+		VertexPaintFunctions::GetGeometryCollectionVertexColors(geometryCollectionComponent, destination);
+		return;
+	}
+
+#endif
+
+	// The component is gone since the view was created
+	FMemory::Memzero(destination.GetData(), destination.Num() * sizeof(FColor));
+}
+
+
+//-------------------------------------------------------
+
+// Resolve Colors
+
+void FVertexColorsReadView::ResolveColors() const {
+
+	if (convertOnRead) {
+
+		heldVertexColors.SetNumUninitialized(amountOfVerticesToConvert);
+		ConvertVertexColorsInto(heldVertexColors);
+
+		viewedVertexColors = heldVertexColors;
+		convertOnRead = false;
+		return;
+	}
+
+	if (!isUniform) return;
+	if (viewedVertexColors.Num() == amountOfUniformVertices) return;
+
+	heldVertexColors.Init(uniformColor, amountOfUniformVertices);
+	viewedVertexColors = heldVertexColors;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+#include "VertexColorsSnapshot.h"
+
+class UPrimitiveComponent;
+class FColorVertexBuffer;
+
+
+//-------------------------------------------------------
+
+// Vertex Colors Read View
+
+// Read only view straight into the CPU side colors of a components Override Vertex Colors, or the source meshes Color Vertex Buffer if it hasn't been painted, so detection, stats and saving can look at the colors without them being copied into a new array first. 
+// The view points into a buffer that the component owns, which gets replaced when paint is applied or the mesh gets switched, so it should be used right away on the Game Thread and not be kept around. IsValid() can be used to check that the buffer it points into is still the one in use. 
+// If there is no CPU data to point to because a mesh has never been painted and has an uninitialized color buffer, the view is Uniform, i.e. just the one color and the amount of vertices, and only fills an array if something asks for one. Dynamic Meshes and Geometry Collections that doesn't store their colors as FColors are converted when they're read, either with CopyTo straight into memory the caller owns, or into an array the view holds if something asks for one. Either way it's the same colors the copying functions would return. 
+
+class FVertexColorsReadView {
+
+public:
+
+	FVertexColorsReadView() = default;
+
+	// Not copyable since a copy of a view that holds its own colors would point to the colors of the original
+	FVertexColorsReadView(const FVertexColorsReadView&) = delete;
+	FVertexColorsReadView& operator=(const FVertexColorsReadView&) = delete;
+
+	FVertexColorsReadView(FVertexColorsReadView&&) = default;
+	FVertexColorsReadView& operator=(FVertexColorsReadView&&) = default;
+
+	static FVertexColorsReadView Create(UPrimitiveComponent* meshComponent, int32 lod);
+
+	// A view that holds colors that doesn't come from a component buffer, e.g. ones restored from a snapshot that hasn't been applied yet
+	static FVertexColorsReadView CreateHoldingVertexColors(TArray<FColor>&& vertexColors);
+
+
+	// If the view is Uniform or has to be converted this is where the colors gets filled in, so only call it if you actually need them as an array
+	TConstArrayView<FColor> GetColors() const { ResolveColors(); return viewedVertexColors; }
+
+	int32 Num() const { return isUniform ? amountOfUniformVertices : (convertOnRead ? amountOfVerticesToConvert : viewedVertexColors.Num()); }
+
+	const FColor* GetData() const { ResolveColors(); return viewedVertexColors.GetData(); }
+
+	const FColor& operator[](int32 vertexIndex) const {
+
+		if (isUniform) return uniformColor;
+
+		ResolveColors();
+		return viewedVertexColors[vertexIndex];
+	}
+
+	// Writes the colors into memory the caller owns, which has to have room for Num() colors. Uniform and converted views writes straight into it without filling in an array of their own first. 
+	void CopyTo(TArrayView<FColor> destination) const;
+
+	// If every vertex has the same color because the mesh has never been painted, in which case nothing has been allocated for them and things like stats can just use GetUniformColor()
+	bool IsUniform() const { return isUniform; }
+
+	FColor GetUniformColor() const { return uniformColor; }
+
+	// If the view points into a components buffer, or into a snapshot a cold component shares with others, if not it holds its own copy of the colors
+	bool IsZeroCopy() const { return viewedColorVertexBuffer != nullptr || heldVertexColorsSnapshot.IsValid(); }
+
+	// False if the component is gone, or the buffer we point into is no longer the one the component uses at the LOD
+	bool IsValid() const;
+
+	// Only copies if you actually need to own the colors
+	TArray<FColor> ToArray() const;
+
+	TArray<FColor> MoveToArray();
+
+
+private:
+
+	static FColorVertexBuffer* GetColorVertexBufferInUse(UPrimitiveComponent* meshComponent, int32 lod);
+
+	void ViewColorVertexBuffer(UPrimitiveComponent* meshComponent, int32 lod, FColorVertexBuffer* colorVertexBuffer);
+
+	void HoldVertexColors(TArray<FColor>&& vertexColors);
+
+	void HoldVertexColorsSnapshot(const FVertexColorsSnapshotRef& vertexColorsSnapshot);
+
+	void HoldUniformColor(const FColor& color, int32 amountOfVertices);
+
+	void ConvertOnRead(UPrimitiveComponent* meshComponent, int32 amountOfVertices);
+
+	void ConvertVertexColorsInto(TArrayView<FColor> destination) const;
+
+	void ResolveColors() const;
+
+
+	mutable TConstArrayView<FColor> viewedVertexColors;
+
+	TWeakObjectPtr<UPrimitiveComponent> viewedMeshComponent;
+	int32 viewedLOD = 0;
+	const FColorVertexBuffer* viewedColorVertexBuffer = nullptr;
+
+	// Colors we had to convert, or that was filled in from the uniform color the first time they were needed as an array. Views are only used on the thread that created them so filling them in doesn't need a lock. 
+	mutable TArray<FColor> heldVertexColors;
+
+	// Keeps the snapshot alive for as long as the view points into it, since the cold component may be warmed up and let go of it in the meantime
+	FVertexColorsSnapshotPtr heldVertexColorsSnapshot;
+
+	bool isUniform = false;
+	FColor uniformColor = FColor(0, 0, 0, 0);
+	int32 amountOfUniformVertices = 0;
+
+	// Dynamic Meshes and Geometry Collections, until they've been converted into heldVertexColors
+	mutable bool convertOnRead = false;
+	TWeakObjectPtr<UPrimitiveComponent> meshComponentToConvert;
+	int32 amountOfVerticesToConvert = 0;
+};
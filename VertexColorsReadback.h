@@ -0,0 +1,58 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VertexColorsReadView.h"
+
+class UPrimitiveComponent;
+
+
+//-------------------------------------------------------
+
+// Read Vertex Colors Into
+
+// Fills a buffer the caller owns with the colors of a component at a LOD, so things that reads lots of meshes every frame can keep reusing the same allocation instead of getting a new TArray every time. Works with any allocator, so it can also be backed by a frame allocator, e.g. TArray<FColor, TMemStackAllocator<>> inside of an FMemMark scope. Returns false and leaves the buffer empty if there where no colors to get.
+
+template<typename AllocatorType>
+bool ReadVertexColorsInto(UPrimitiveComponent* meshComponent, int32 lod, TArray<FColor, AllocatorType>& vertexColors) {
+
+	vertexColors.Reset();
+
+	const FVertexColorsReadView vertexColorsReadView_Local = FVertexColorsReadView::Create(meshComponent, lod);
+
+	if (vertexColorsReadView_Local.Num() <= 0) return false;
+
+	// Uniform views, and Dynamic Meshes and Geometry Collections that has to be converted, are written straight into the buffer
+	vertexColors.SetNumUninitialized(vertexColorsReadView_Local.Num());
+	vertexColorsReadView_Local.CopyTo(TArrayView<FColor>(vertexColors.GetData(), vertexColors.Num()));
+
+	return true;
+}
+
+
+//-------------------------------------------------------
+
+// Vertex Colors Bulk Readback
+
+// The colors of many components in one contiguous block, where the colors of a component are from componentFirstVertex[i] up to componentFirstVertex[i + 1]. Components without any colors get an empty range so the table always lines up with the components that where passed in. Can be reused between reads since it's only Reset, not freed. 
+
+struct FVertexColorsBulkReadback {
+
+	TArray<FColor> vertexColors;
+	TArray<int32> componentFirstVertex;
+
+
+	int32 NumComponents() const { return FMath::Max(0, componentFirstVertex.Num() - 1); }
+
+	TConstArrayView<FColor> GetComponentColors(int32 componentIndex) const {
+
+		if (!componentFirstVertex.IsValidIndex(componentIndex + 1)) return TConstArrayView<FColor>();
+
+		return TConstArrayView<FColor>(vertexColors.GetData() + componentFirstVertex[componentIndex], componentFirstVertex[componentIndex + 1] - componentFirstVertex[componentIndex]);
+	}
+
+	void Reset() {
+
+		vertexColors.Reset();
+		componentFirstVertex.Reset();
+	}
+};
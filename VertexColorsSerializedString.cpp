@@ -0,0 +1,146 @@
+#include "VertexColorsSerializedString.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+
+
+static TAutoConsoleVariable<int32> CVarVertexPaintSerializedColorsParallelColorThreshold(
+	TEXT("VertexPaint.SerializedColors.ParallelColorThreshold"),
+	65536,
+	TEXT("Serialized color strings with at least this many colors gets decoded in chunks in parallel with ParallelFor. 0 or less means they're always decoded on one thread. "),
+	ECVF_Default);
+
+
+//-------------------------------------------------------
+
+// Hex Digit Table
+
+// The value of every ASCII character as a hex digit, with 0 for anything that isn't one, the same as FParse::HexDigit
+struct FVertexColorsHexDigitTable {
+
+	uint8 hexDigitValues[128];
+
+	FVertexColorsHexDigitTable() {
+
+		FMemory::Memzero(hexDigitValues, sizeof(hexDigitValues));
+
+		for (int32 i = 0; i < 10; i++)
+			hexDigitValues['0' + i] = static_cast<uint8>(i);
+
+		for (int32 i = 0; i < 6; i++) {
+
+			hexDigitValues['a' + i] = static_cast<uint8>(10 + i);
+			hexDigitValues['A' + i] = static_cast<uint8>(10 + i);
+		}
+	}
+
+	FORCEINLINE uint8 GetHexByte(TCHAR highDigit, TCHAR lowDigit) const {
+
+		// Characters outside of ASCII are masked into the table and then zeroed, so there are no branches per digit
+		const uint32 highDigitValue_Local = hexDigitValues[static_cast<uint32>(highDigit) & 0x7F] * (static_cast<uint32>(highDigit) < 128);
+		const uint32 lowDigitValue_Local = hexDigitValues[static_cast<uint32>(lowDigit) & 0x7F] * (static_cast<uint32>(lowDigit) < 128);
+
+		return static_cast<uint8>((highDigitValue_Local << 4) | lowDigitValue_Local);
+	}
+};
+
+static const FVertexColorsHexDigitTable& GetVertexColorsHexDigitTable() {
+
+	static const FVertexColorsHexDigitTable hexDigitTable;
+	return hexDigitTable;
+}
+
+
+static void DecodeSerializedColorRecords(const TCHAR* serializedColors, int32 amountOfColors, FColor* vertexColors) {
+
+	const FVertexColorsHexDigitTable& hexDigitTable_Local = GetVertexColorsHexDigitTable();
+
+	for (int32 i = 0; i < amountOfColors; i++) {
+
+		const TCHAR* record_Local = serializedColors + i * FVertexColorsSerializedString::CharactersPerColor;
+
+		vertexColors[i] = FColor(
+			hexDigitTable_Local.GetHexByte(record_Local[0], record_Local[1]),
+			hexDigitTable_Local.GetHexByte(record_Local[2], record_Local[3]),
+			hexDigitTable_Local.GetHexByte(record_Local[4], record_Local[5]),
+			hexDigitTable_Local.GetHexByte(record_Local[6], record_Local[7]));
+	}
+}
+
+
+//-------------------------------------------------------
+
+// Encode
+
+FString FVertexColorsSerializedString::Encode(TConstArrayView<FColor> vertexColors) {
+
+	FString serializedColors_Local;
+	serializedColors_Local.Reserve(vertexColors.Num() * CharactersPerColor);
+
+	for (const FColor& vertexColorTemp : vertexColors)
+		serializedColors_Local += vertexColorTemp.ToHex();
+
+	return serializedColors_Local;
+}
+
+
+//-------------------------------------------------------
+
+// Decode
+
+bool FVertexColorsSerializedString::Decode(const FString& serializedColors, TArray<FColor>& vertexColors) {
+
+	vertexColors.Reset();
+
+	if (serializedColors.Len() <= 0 || serializedColors.Len() % CharactersPerColor != 0) return false;
+
+
+	const int32 amountOfColors_Local = serializedColors.Len() / CharactersPerColor;
+	const TCHAR* serializedColorsData_Local = *serializedColors;
+
+	// Allocated once up front so every chunk can write straight into its part of it
+	vertexColors.SetNumUninitialized(amountOfColors_Local);
+	FColor* vertexColorsData_Local = vertexColors.GetData();
+
+	const int32 parallelColorThreshold_Local = CVarVertexPaintSerializedColorsParallelColorThreshold.GetValueOnAnyThread();
+
+	if (parallelColorThreshold_Local <= 0 || amountOfColors_Local < parallelColorThreshold_Local) {
+
+		DecodeSerializedColorRecords(serializedColorsData_Local, amountOfColors_Local, vertexColorsData_Local);
+		return true;
+	}
+
+
+	// Chunks are on record boundaries so they never share a color, and since each record decodes on its own the result is the same no matter how it's split
+	const int32 colorsPerChunk_Local = 64 * 1024;
+	const int32 amountOfChunks_Local = FMath::DivideAndRoundUp(amountOfColors_Local, colorsPerChunk_Local);
+
+	ParallelFor(amountOfChunks_Local, [&](int32 chunkIndex) {
+
+		const int32 chunkStartIndex_Local = chunkIndex * colorsPerChunk_Local;
+		const int32 amountOfColorsInChunk_Local = FMath::Min(colorsPerChunk_Local, amountOfColors_Local - chunkStartIndex_Local);
+
+		DecodeSerializedColorRecords(serializedColorsData_Local + chunkStartIndex_Local * CharactersPerColor, amountOfColorsInChunk_Local, vertexColorsData_Local + chunkStartIndex_Local);
+	});
+
+	return true;
+}
+
+
+//-------------------------------------------------------
+
+// Decode Reference
+
+bool FVertexColorsSerializedString::Decode_Reference(const FString& serializedColors, TArray<FColor>& vertexColors) {
+
+	vertexColors.Reset();
+
+	if (serializedColors.Len() <= 0 || serializedColors.Len() % CharactersPerColor != 0) return false;
+
+
+	vertexColors.Reserve(serializedColors.Len() / CharactersPerColor);
+
+	for (int32 i = 0; i < serializedColors.Len(); i += CharactersPerColor)
+		vertexColors.Add(FColor::FromHex(serializedColors.Mid(i, CharactersPerColor)));
+
+	return true;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+//-------------------------------------------------------
+
+// Vertex Colors Serialized String
+
+// Decoding of serialized color strings where every color is a fixed width record of 8 hex digits, RRGGBBAA, the same as FColor::ToHex. Since every record is the same length the string can be split anywhere on a multiple of 8 characters, so large strings are decoded in chunks in parallel straight into the color array. 
+// Every record decodes to exactly what FColor::FromHex gives for it, including that invalid digits are read as 0, so it can replace decoding the records one at a time. 
+// Set Mesh Component Vertex Colors Using Serialized String still runs its task with the string and decodes it the way it always has, since the format that task and whatever produced the saved strings uses hasn't been checked against this. Until it has, this is only used when called directly. 
+
+class FVertexColorsSerializedString {
+
+public:
+
+	static const int32 CharactersPerColor = 8;
+
+	static FString Encode(TConstArrayView<FColor> vertexColors);
+
+	// Returns false, with vertexColors empty, if the string isn't a whole number of records
+	static bool Decode(const FString& serializedColors, TArray<FColor>& vertexColors);
+
+	// Decodes one record at a time with FColor::FromHex. Kept as the reference the fast path is compared against. 
+	static bool Decode_Reference(const FString& serializedColors, TArray<FColor>& vertexColors);
+};
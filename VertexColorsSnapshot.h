@@ -0,0 +1,25 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+//-------------------------------------------------------
+
+// Vertex Colors Snapshot
+
+// Immutable, reference counted vertex colors. Can be handed to any amount of background tasks at the cost of a refcount bump instead of copying the whole color array, since nobody is allowed to change the colors once they're in a snapshot.
+
+typedef TSharedRef<const TArray<FColor>, ESPMode::ThreadSafe> FVertexColorsSnapshotRef;
+typedef TSharedPtr<const TArray<FColor>, ESPMode::ThreadSafe> FVertexColorsSnapshotPtr;
+
+
+// Moves the colors into a new snapshot, so if you already own the array, for instance from a task result, it doesn't get copied
+inline FVertexColorsSnapshotRef MakeVertexColorsSnapshot(TArray<FColor>&& vertexColors) {
+
+	return MakeShared<TArray<FColor>, ESPMode::ThreadSafe>(MoveTemp(vertexColors));
+}
+
+inline FVertexColorsSnapshotRef MakeVertexColorsSnapshot(const TArray<FColor>& vertexColors) {
+
+	return MakeShared<TArray<FColor>, ESPMode::ThreadSafe>(vertexColors);
+}
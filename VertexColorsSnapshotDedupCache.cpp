@@ -0,0 +1,244 @@
+#include "VertexColorsSnapshotDedupCache.h"
+#include "Components/PrimitiveComponent.h"
+#include "Hash/CityHash.h"
+
+
+//-------------------------------------------------------
+
+// Get
+
+FVertexColorsSnapshotDedupCache& FVertexColorsSnapshotDedupCache::Get() {
+
+	static FVertexColorsSnapshotDedupCache vertexColorsSnapshotDedupCache;
+	return vertexColorsSnapshotDedupCache;
+}
+
+
+//-------------------------------------------------------
+
+// Find Or Add Component Colors
+
+FVertexColorsSnapshotRef FVertexColorsSnapshotDedupCache::FindOrAddComponentColors(const UPrimitiveComponent* meshComponent, const UObject* sourceMesh, int32 lod, TConstArrayView<FColor> vertexColors, uint64 colorsGeneration) {
+
+	if (!IsValid(meshComponent)) return MakeVertexColorsSnapshot(TArray<FColor>(vertexColors.GetData(), vertexColors.Num()));
+
+
+	{
+		FScopeLock scopeLock_Local(&sharedColorsCriticalSection);
+
+		// Most of the time the component hasn't been painted since it last got its snapshot, so comparing with it is all we have to do, without hashing or allocating anything
+		if (FComponentColors* componentColors_Local = colorsPerComponentLOD.Find({ meshComponent, lod })) {
+
+			if (FVertexColorsSnapshotPtr componentSnapshot_Local = componentColors_Local->sharedColors.Pin()) {
+
+				if (AreColorsIdentical(*componentSnapshot_Local, vertexColors)) {
+
+					componentColors_Local->colorsGeneration = colorsGeneration;
+					return componentSnapshot_Local.ToSharedRef();
+				}
+			}
+		}
+	}
+
+
+	// The colors diverged, or it's the first time, so the component forks off to whatever array has its colors now
+	FVertexColorsSnapshotRef sharedSnapshot_Local = FindOrAddSharedColors(sourceMesh, lod, vertexColors);
+
+	FScopeLock scopeLock_Local(&sharedColorsCriticalSection);
+
+	colorsPerComponentLOD.Add({ meshComponent, lod }, FComponentColors { sharedSnapshot_Local, colorsGeneration });
+
+	return sharedSnapshot_Local;
+}
+
+
+//-------------------------------------------------------
+
+// Find Shared Component Colors
+
+FVertexColorsSnapshotPtr FVertexColorsSnapshotDedupCache::FindSharedComponentColors(const UPrimitiveComponent* meshComponent, const UObject* sourceMesh, int32 lod, TConstArrayView<FColor> vertexColors, uint64 colorsGeneration) {
+
+	if (!IsValid(meshComponent)) return nullptr;
+
+
+	uint64 colorsHash_Local = 0;
+	FVertexColorsSnapshotPtr sharedSnapshot_Local = FindSharedColors(sourceMesh, lod, vertexColors, colorsHash_Local);
+
+	if (!sharedSnapshot_Local) return nullptr;
+
+
+	FScopeLock scopeLock_Local(&sharedColorsCriticalSection);
+
+	colorsPerComponentLOD.Add({ meshComponent, lod }, FComponentColors { sharedSnapshot_Local, colorsGeneration });
+
+	return sharedSnapshot_Local;
+}
+
+
+//-------------------------------------------------------
+
+// Find Component Colors At Generation
+
+FVertexColorsSnapshotPtr FVertexColorsSnapshotDedupCache::FindComponentColorsAtGeneration(const UPrimitiveComponent* meshComponent, int32 lod, uint64 colorsGeneration) const {
+
+	if (!IsValid(meshComponent)) return nullptr;
+
+
+	FScopeLock scopeLock_Local(&sharedColorsCriticalSection);
+
+	const FComponentColors* componentColors_Local = colorsPerComponentLOD.Find({ meshComponent, lod });
+
+	if (!componentColors_Local || componentColors_Local->colorsGeneration != colorsGeneration) return nullptr;
+
+	return componentColors_Local->sharedColors.Pin();
+}
+
+
+//-------------------------------------------------------
+
+// Find Or Add Shared Colors
+
+FVertexColorsSnapshotRef FVertexColorsSnapshotDedupCache::FindOrAddSharedColors(const UObject* sourceMesh, int32 lod, TConstArrayView<FColor> vertexColors) {
+
+	// Only shared between components of the same mesh and LOD, since other meshes having the same colors is just a coincidence
+	if (!IsValid(sourceMesh)) return MakeVertexColorsSnapshot(TArray<FColor>(vertexColors.GetData(), vertexColors.Num()));
+
+
+	uint64 colorsHash_Local = 0;
+
+	if (FVertexColorsSnapshotPtr sharedSnapshot_Local = FindSharedColors(sourceMesh, lod, vertexColors, colorsHash_Local))
+		return sharedSnapshot_Local.ToSharedRef();
+
+
+	FVertexColorsSnapshotRef newSnapshot_Local = MakeVertexColorsSnapshot(TArray<FColor>(vertexColors.GetData(), vertexColors.Num()));
+
+	FScopeLock scopeLock_Local(&sharedColorsCriticalSection);
+
+	sharedColors.FindOrAdd({ sourceMesh, lod, colorsHash_Local }).Add(newSnapshot_Local);
+
+	// Every now and then clears out arrays that nobody holds anymore and components and meshes that are gone
+	if (++amountOfAddsSinceRemovingExpired >= 64) {
+
+		RemoveExpiredColors();
+		amountOfAddsSinceRemovingExpired = 0;
+	}
+
+	return newSnapshot_Local;
+}
+
+
+//-------------------------------------------------------
+
+// Find Shared Colors
+
+FVertexColorsSnapshotPtr FVertexColorsSnapshotDedupCache::FindSharedColors(const UObject* sourceMesh, int32 lod, TConstArrayView<FColor> vertexColors, uint64& colorsHash) const {
+
+	if (!IsValid(sourceMesh)) return nullptr;
+
+
+	// Hashed before locking so other threads doesn't have to wait on it
+	colorsHash = CityHash64(reinterpret_cast<const char*>(vertexColors.GetData()), vertexColors.Num() * sizeof(FColor));
+
+	FScopeLock scopeLock_Local(&sharedColorsCriticalSection);
+
+	if (const TArray<FSharedColorsWeakPtr, TInlineAllocator<1>>* sharedColorsWithHash_Local = sharedColors.Find({ sourceMesh, lod, colorsHash })) {
+
+		for (const FSharedColorsWeakPtr& sharedColorsTemp : *sharedColorsWithHash_Local) {
+
+			if (FVertexColorsSnapshotPtr sharedSnapshot_Local = sharedColorsTemp.Pin()) {
+
+				if (AreColorsIdentical(*sharedSnapshot_Local, vertexColors))
+					return sharedSnapshot_Local;
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+
+//-------------------------------------------------------
+
+// Are Colors Identical
+
+bool FVertexColorsSnapshotDedupCache::AreColorsIdentical(const TArray<FColor>& sharedColors, TConstArrayView<FColor> vertexColors) {
+
+	if (sharedColors.Num() != vertexColors.Num()) return false;
+	if (sharedColors.Num() <= 0) return true;
+
+	return FMemory::Memcmp(sharedColors.GetData(), vertexColors.GetData(), sharedColors.Num() * sizeof(FColor)) == 0;
+}
+
+
+//-------------------------------------------------------
+
+// Remove Expired Colors
+
+void FVertexColorsSnapshotDedupCache::RemoveExpiredColors() {
+
+	for (auto it = sharedColors.CreateIterator(); it; ++it) {
+
+		if (!it.Key().sourceMesh.IsValid()) {
+
+			it.RemoveCurrent();
+			continue;
+		}
+
+		it.Value().RemoveAll([](const FSharedColorsWeakPtr& sharedColorsTemp) { return !sharedColorsTemp.IsValid(); });
+
+		if (it.Value().Num() <= 0)
+			it.RemoveCurrent();
+	}
+
+	for (auto it = colorsPerComponentLOD.CreateIterator(); it; ++it) {
+
+		if (!it.Key().meshComponent.IsValid() || !it.Value().sharedColors.IsValid())
+			it.RemoveCurrent();
+	}
+}
+
+
+//-------------------------------------------------------
+
+// Remove Component
+
+void FVertexColorsSnapshotDedupCache::RemoveComponent(const UPrimitiveComponent* meshComponent) {
+
+	FScopeLock scopeLock_Local(&sharedColorsCriticalSection);
+
+	const TWeakObjectPtr<const UPrimitiveComponent> meshComponentWeak_Local = meshComponent;
+
+	for (auto it = colorsPerComponentLOD.CreateIterator(); it; ++it) {
+
+		if (it.Key().meshComponent == meshComponentWeak_Local)
+			it.RemoveCurrent();
+	}
+}
+
+
+//-------------------------------------------------------
+
+// Get Amount Of Shared Colors
+
+void FVertexColorsSnapshotDedupCache::GetAmountOfSharedColors(int32& amountOfColorArrays, int32& amountOfComponents) const {
+
+	amountOfColorArrays = 0;
+	amountOfComponents = 0;
+
+	FScopeLock scopeLock_Local(&sharedColorsCriticalSection);
+
+	for (const auto& sharedColorsTemp : sharedColors) {
+
+		for (const FSharedColorsWeakPtr& sharedColorsWithHashTemp : sharedColorsTemp.Value) {
+
+			if (sharedColorsWithHashTemp.IsValid())
+				amountOfColorArrays++;
+		}
+	}
+
+	for (const auto& componentColorsTemp : colorsPerComponentLOD) {
+
+		if (componentColorsTemp.Key.meshComponent.IsValid() && componentColorsTemp.Value.sharedColors.IsValid())
+			amountOfComponents++;
+	}
+}
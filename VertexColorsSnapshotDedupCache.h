@@ -0,0 +1,88 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+#include "VertexColorsSnapshot.h"
+
+class UPrimitiveComponent;
+
+
+//-------------------------------------------------------
+
+// Vertex Colors Snapshot Dedup Cache
+
+// Content hashed, reference counted Vertex Colors Snapshots, so when several components of the same source mesh has identical colors, for instance after the same color snippet was applied to all of them, the snapshots taken of them share one array instead of each snapshot having its own copy. 
+// The components own override buffers are still one per component, since the engine has each LOD own and free its override buffer, but when Cold Storage cools down a component whose colors are identical to an array that is alive here, it drops the CPU side copy of the buffer and serves reads from the shared array instead. 
+// The cache only holds weak references, so an array lives for as long as any snapshot of it is held, and each component remembers the array it got last. When a component's colors diverge from it, e.g. on its first paint after the snippet, its next snapshot gets another array, while the others keep sharing the old one. 
+
+class FVertexColorsSnapshotDedupCache {
+
+public:
+
+	static FVertexColorsSnapshotDedupCache& Get();
+
+	// Returns the snapshot the component already has if its colors haven't changed, otherwise one that is already shared by another component of the same source mesh and LOD with identical colors, and only if there is none is a new one made. colorsGeneration is the components color generation the colors were read at. 
+	FVertexColorsSnapshotRef FindOrAddComponentColors(const UPrimitiveComponent* meshComponent, const UObject* sourceMesh, int32 lod, TConstArrayView<FColor> vertexColors, uint64 colorsGeneration);
+
+	// Same as Find Or Add Component Colors, but only if there already is an array alive with the colors, which is then registered as the component's. Used by Cold Storage, where a new array would cost as much as the CPU copy it's dropping. 
+	FVertexColorsSnapshotPtr FindSharedComponentColors(const UPrimitiveComponent* meshComponent, const UObject* sourceMesh, int32 lod, TConstArrayView<FColor> vertexColors, uint64 colorsGeneration);
+
+	// The snapshot the component got last, if it's still alive and was read at the same color generation, in which case the colors doesn't have to be read at all
+	FVertexColorsSnapshotPtr FindComponentColorsAtGeneration(const UPrimitiveComponent* meshComponent, int32 lod, uint64 colorsGeneration) const;
+
+	// If the component swapped mesh its colors can't be shared with the previous mesh's anymore
+	void RemoveComponent(const UPrimitiveComponent* meshComponent);
+
+	// How many distinct color arrays are alive, and how many components are sharing them
+	void GetAmountOfSharedColors(int32& amountOfColorArrays, int32& amountOfComponents) const;
+
+
+private:
+
+	FVertexColorsSnapshotRef FindOrAddSharedColors(const UObject* sourceMesh, int32 lod, TConstArrayView<FColor> vertexColors);
+
+	FVertexColorsSnapshotPtr FindSharedColors(const UObject* sourceMesh, int32 lod, TConstArrayView<FColor> vertexColors, uint64& colorsHash) const;
+
+	static bool AreColorsIdentical(const TArray<FColor>& sharedColors, TConstArrayView<FColor> vertexColors);
+
+	void RemoveExpiredColors();
+
+
+	struct FSharedColorsKey {
+
+		TWeakObjectPtr<const UObject> sourceMesh;
+		int32 lod = 0;
+		uint64 colorsHash = 0;
+
+		bool operator==(const FSharedColorsKey& other) const { return sourceMesh == other.sourceMesh && lod == other.lod && colorsHash == other.colorsHash; }
+
+		friend uint32 GetTypeHash(const FSharedColorsKey& sharedColorsKey) { return HashCombine(HashCombine(GetTypeHash(sharedColorsKey.sourceMesh), GetTypeHash(sharedColorsKey.lod)), GetTypeHash(sharedColorsKey.colorsHash)); }
+	};
+
+	struct FComponentColorsKey {
+
+		TWeakObjectPtr<const UPrimitiveComponent> meshComponent;
+		int32 lod = 0;
+
+		bool operator==(const FComponentColorsKey& other) const { return meshComponent == other.meshComponent && lod == other.lod; }
+
+		friend uint32 GetTypeHash(const FComponentColorsKey& componentColorsKey) { return HashCombine(GetTypeHash(componentColorsKey.meshComponent), GetTypeHash(componentColorsKey.lod)); }
+	};
+
+	typedef TWeakPtr<const TArray<FColor>, ESPMode::ThreadSafe> FSharedColorsWeakPtr;
+
+	struct FComponentColors {
+
+		FSharedColorsWeakPtr sharedColors;
+		uint64 colorsGeneration = 0;
+	};
+
+	mutable FCriticalSection sharedColorsCriticalSection;
+
+	// Several arrays can have the same hash, so each hash has all of the arrays with it that are alive
+	TMap<FSharedColorsKey, TArray<FSharedColorsWeakPtr, TInlineAllocator<1>>> sharedColors;
+
+	TMap<FComponentColorsKey, FComponentColors> colorsPerComponentLOD;
+
+	int32 amountOfAddsSinceRemovingExpired = 0;
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VertexPaintFunctionLibrary.h"
+
+
+//-------------------------------------------------------
+
+// Vertex Detect Ranked Physics Surface Results
+
+// Compact version of the physicsSurfacesResult TMap, sorted from the most to the least painted physics surface. There can never be more physics surfaces than SurfaceType_Max so the elements are allocated inline, which means filling and sorting it never allocates and can be iterated by rank right away without building any TMap. Useful for things like footsteps where you get a detection result all the time.
+
+struct FVertexDetectRankedPhysicsSurfaceResults {
+
+	typedef TPair<TEnumAsByte<EPhysicalSurface>, FVertexDetectAmountOfPaintedColorsOfEachChannel_Results> FRankedPhysicsSurfaceResult;
+
+	TArray<FRankedPhysicsSurfaceResult, TInlineAllocator<SurfaceType_Max>> physicsSurfacesByRank;
+
+
+	int32 Num() const { return physicsSurfacesByRank.Num(); }
+
+	const FRankedPhysicsSurfaceResult& operator[](int32 rank) const { return physicsSurfacesByRank[rank]; }
+
+	// Linear search since there are at most SurfaceType_Max elements, which is quicker than hashing at these sizes
+	const FVertexDetectAmountOfPaintedColorsOfEachChannel_Results* Find(TEnumAsByte<EPhysicalSurface> physicsSurface) const {
+
+		for (const FRankedPhysicsSurfaceResult& rankedPhysicsSurfaceResultTemp : physicsSurfacesByRank) {
+
+			if (rankedPhysicsSurfaceResultTemp.Key == physicsSurface)
+				return &rankedPhysicsSurfaceResultTemp.Value;
+		}
+
+		return nullptr;
+	}
+
+	auto begin() const { return physicsSurfacesByRank.begin(); }
+	auto end() const { return physicsSurfacesByRank.end(); }
+};
@@ -0,0 +1,434 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "VertexPaintFunctionLibrary.h"
+#include "VertexColorChannelsHistogram.h"
+#include "VertexDetectRankedPhysicsSurfaceResults.h"
+#include "VertexColorsSerializedString.h"
+#include "VertexColorsReadView.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformTLS.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/DateTime.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+#if ENGINE_MAJOR_VERSION == 5
+#include "Components/DynamicMeshComponent.h"
+#include "UDynamicMesh.h"
+#include "DynamicMesh/DynamicMesh3.h"
+#endif
+
+#include <atomic>
+
+
+// Benchmarks for the vertex color kernels, so we can see if an upgrade made any of them slower. Doesn't need a GPU or any assets since every mesh and color array is generated, so it can be run on a build machine with something like:
+// UnrealEditor-Cmd <Project> -ExecCmds="Automation RunTests VertexPaint.Benchmarks; Quit" -nullrhi -unattended -nosplash
+// The results are logged and saved as a CSV to Saved/VertexPaintBenchmarks/.
+// Allocations and peak memory are only measured if -VertexPaintBenchmarkAllocations is on the command line, since that replaces GMalloc for the rest of the process, which slows down every allocation. Without it those columns are -1. 
+
+
+//-------------------------------------------------------
+
+// Vertex Paint Benchmark Malloc
+
+// Forwards everything to the allocator that was in use and counts allocations and the amount of memory that is alive while a kernel is being measured. It's put in place the first time a benchmark runs with -VertexPaintBenchmarkAllocations and then kept for the rest of the process, since memory that was allocated through it can be freed at any time later, so that should only be used for processes that are just there to run the benchmarks. 
+// Only counts what the thread that measures allocates and frees, so other threads doing their own thing at the same time doesn't end up in the numbers. Allocations that a kernel makes on ParallelFor workers aren't counted either. 
+
+class FVertexPaintBenchmarkMalloc : public FMalloc {
+
+public:
+
+	// Null unless the command line has asked for it, in which case it's installed the first time this is called
+	static FVertexPaintBenchmarkMalloc* Get() {
+
+		static FVertexPaintBenchmarkMalloc* benchmarkMalloc_Local = FParse::Param(FCommandLine::Get(), TEXT("VertexPaintBenchmarkAllocations")) ? Install() : nullptr;
+		return benchmarkMalloc_Local;
+	}
+
+	virtual void* Malloc(SIZE_T Count, uint32 Alignment) override {
+
+		void* allocation_Local = usedMalloc->Malloc(Count, Alignment);
+		TrackAllocated(allocation_Local, Count);
+		return allocation_Local;
+	}
+
+	virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override {
+
+		TrackFreed(Original);
+		void* allocation_Local = usedMalloc->Realloc(Original, Count, Alignment);
+		TrackAllocated(allocation_Local, Count);
+		return allocation_Local;
+	}
+
+	virtual void Free(void* Original) override {
+
+		TrackFreed(Original);
+		usedMalloc->Free(Original);
+	}
+
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return usedMalloc->GetAllocationSize(Original, SizeOut); }
+
+	virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return usedMalloc->QuantizeSize(Count, Alignment); }
+
+	virtual void Trim(bool bTrimThreadCaches) override { usedMalloc->Trim(bTrimThreadCaches); }
+
+	virtual bool IsInternallyThreadSafe() const override { return usedMalloc->IsInternallyThreadSafe(); }
+
+	virtual const TCHAR* GetDescriptiveName() override { return TEXT("VertexPaintBenchmarkMalloc"); }
+
+
+	void StartMeasuring() {
+
+		amountOfAllocations = 0;
+		amountOfBytesAllocated = 0;
+		amountOfBytesAlive = 0;
+		peakAmountOfBytesAlive = 0;
+
+		measuringThreadId = FPlatformTLS::GetCurrentThreadId();
+		isMeasuring = true;
+	}
+
+	void StopMeasuring() {
+
+		isMeasuring = false;
+	}
+
+	int64 GetAmountOfAllocations() const { return amountOfAllocations.load(); }
+
+	int64 GetAmountOfBytesAllocated() const { return amountOfBytesAllocated.load(); }
+
+	int64 GetPeakAmountOfBytesAlive() const { return peakAmountOfBytesAlive.load(); }
+
+
+private:
+
+	explicit FVertexPaintBenchmarkMalloc(FMalloc* innerMalloc) : usedMalloc(innerMalloc) {}
+
+	// FMalloc is allocated with the system allocator, so this doesn't go through GMalloc while we're replacing it
+	static FVertexPaintBenchmarkMalloc* Install() {
+
+		FVertexPaintBenchmarkMalloc* benchmarkMalloc_Local = new FVertexPaintBenchmarkMalloc(GMalloc);
+		GMalloc = benchmarkMalloc_Local;
+
+		return benchmarkMalloc_Local;
+	}
+
+	bool IsMeasuringThread() const {
+
+		return isMeasuring.load(std::memory_order_relaxed) && measuringThreadId.load(std::memory_order_relaxed) == FPlatformTLS::GetCurrentThreadId();
+	}
+
+	void TrackAllocated(void* allocation, SIZE_T requestedSize) {
+
+		if (!allocation) return;
+		if (!IsMeasuringThread()) return;
+
+		SIZE_T allocationSize_Local = requestedSize;
+		usedMalloc->GetAllocationSize(allocation, allocationSize_Local);
+
+		amountOfAllocations++;
+		amountOfBytesAllocated += allocationSize_Local;
+
+		const int64 amountOfBytesAlive_Local = amountOfBytesAlive += allocationSize_Local;
+		int64 peakAmountOfBytesAlive_Local = peakAmountOfBytesAlive.load();
+
+		while (amountOfBytesAlive_Local > peakAmountOfBytesAlive_Local && !peakAmountOfBytesAlive.compare_exchange_weak(peakAmountOfBytesAlive_Local, amountOfBytesAlive_Local)) {}
+	}
+
+	void TrackFreed(void* allocation) {
+
+		if (!IsMeasuringThread()) return;
+
+		// If the allocator can't tell the size we can't subtract it, which only makes the peak higher than it was. Same if it was allocated on this thread but freed on another. 
+		SIZE_T allocationSize_Local = 0;
+
+		if (allocation && usedMalloc->GetAllocationSize(allocation, allocationSize_Local))
+			amountOfBytesAlive -= allocationSize_Local;
+	}
+
+
+	FMalloc* usedMalloc = nullptr;
+
+	std::atomic<int64> amountOfAllocations { 0 };
+	std::atomic<int64> amountOfBytesAllocated { 0 };
+	std::atomic<int64> amountOfBytesAlive { 0 };
+	std::atomic<int64> peakAmountOfBytesAlive { 0 };
+
+	std::atomic<bool> isMeasuring { false };
+	std::atomic<uint32> measuringThreadId { 0 };
+};
+
+
+//-------------------------------------------------------
+
+// Vertex Paint Benchmark
+
+// Runs a kernel until it has run for long enough to get a stable time and keeps the fastest run, then if allocations are measured runs it once more with the counting malloc to get them.
+
+class FVertexPaintBenchmark {
+
+public:
+
+	void Measure(const TCHAR* kernelName, int32 amountOfVertices, TFunctionRef<void()> kernel) {
+
+		const double minTotalSeconds_Local = 0.25;
+		const int32 minAmountOfIterations_Local = 3;
+		const int32 maxAmountOfIterations_Local = 1000;
+
+		// Warm up so the first run doesn't pay for page faults and lazily created thread pools
+		kernel();
+
+		double fastestRunSeconds_Local = TNumericLimits<double>::Max();
+		double totalSeconds_Local = 0;
+		int32 amountOfIterations_Local = 0;
+
+		while (amountOfIterations_Local < maxAmountOfIterations_Local && (amountOfIterations_Local < minAmountOfIterations_Local || totalSeconds_Local < minTotalSeconds_Local)) {
+
+			const uint64 startCycles_Local = FPlatformTime::Cycles64();
+			kernel();
+			const double runSeconds_Local = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - startCycles_Local);
+
+			fastestRunSeconds_Local = FMath::Min(fastestRunSeconds_Local, runSeconds_Local);
+			totalSeconds_Local += runSeconds_Local;
+			amountOfIterations_Local++;
+		}
+
+
+		int64 amountOfAllocations_Local = -1;
+		int64 amountOfBytesAllocated_Local = -1;
+		int64 peakAmountOfBytesAlive_Local = -1;
+
+		if (FVertexPaintBenchmarkMalloc* benchmarkMalloc_Local = FVertexPaintBenchmarkMalloc::Get()) {
+
+			benchmarkMalloc_Local->StartMeasuring();
+			kernel();
+			benchmarkMalloc_Local->StopMeasuring();
+
+			amountOfAllocations_Local = benchmarkMalloc_Local->GetAmountOfAllocations();
+			amountOfBytesAllocated_Local = benchmarkMalloc_Local->GetAmountOfBytesAllocated();
+			peakAmountOfBytesAlive_Local = benchmarkMalloc_Local->GetPeakAmountOfBytesAlive();
+		}
+
+
+		const double nsPerCall_Local = fastestRunSeconds_Local * 1e9;
+
+		csvRows.Add(FString::Printf(TEXT("%s,%d,%d,%.1f,%.4f,%lld,%lld,%lld"),
+			kernelName,
+			amountOfVertices,
+			amountOfIterations_Local,
+			nsPerCall_Local,
+			nsPerCall_Local / FMath::Max(1, amountOfVertices),
+			amountOfAllocations_Local,
+			amountOfBytesAllocated_Local,
+			peakAmountOfBytesAlive_Local));
+	}
+
+	FString GetCSV() const {
+
+		return FString(TEXT("Kernel,Vertices,Iterations,NsPerCall,NsPerVertex,Allocations,BytesAllocated,PeakBytesAlive\n")) + FString::Join(csvRows, TEXT("\n")) + TEXT("\n");
+	}
+
+
+private:
+
+	TArray<FString> csvRows;
+};
+
+
+//-------------------------------------------------------
+
+// Make Synthetic Vertex Colors
+
+// Half of the vertices are unpainted, and the rest have random amounts on every channel, which is roughly what a mesh that has been painted for a while looks like. Seeded so every run gets the same colors.
+
+static TArray<FColor> MakeSyntheticVertexColors(int32 amountOfVertices) {
+
+	FRandomStream randomStream_Local(amountOfVertices);
+
+	TArray<FColor> vertexColors_Local;
+	vertexColors_Local.SetNumUninitialized(amountOfVertices);
+
+	for (FColor& vertexColorTemp : vertexColors_Local) {
+
+		if (randomStream_Local.FRand() < 0.5f)
+			vertexColorTemp = FColor(0, 0, 0, 0);
+		else
+			vertexColorTemp = FColor(randomStream_Local.RandRange(0, 255), randomStream_Local.RandRange(0, 255), randomStream_Local.RandRange(0, 255), randomStream_Local.RandRange(0, 255));
+	}
+
+	return vertexColors_Local;
+}
+
+
+//-------------------------------------------------------
+
+// Make Synthetic Physics Surface Results
+
+static FVertexDetectAmountOfPaintedColorsOfEachChannel MakeSyntheticPhysicsSurfaceResults(int32 amountOfVertices) {
+
+	FRandomStream randomStream_Local(amountOfVertices);
+	FVertexDetectAmountOfPaintedColorsOfEachChannel amountOfPaintedColorsOfEachChannel_Local;
+
+	// Every channel on a couple of materials, which is about as many surfaces a mesh would realistically have
+	for (int32 i = 1; i <= 8; i++) {
+
+		FVertexDetectAmountOfPaintedColorsOfEachChannel_Results& physicsSurfaceResult_Local = amountOfPaintedColorsOfEachChannel_Local.physicsSurfacesResult.Add(static_cast<EPhysicalSurface>(i));
+		physicsSurfaceResult_Local.amountOfVerticesConsidered = amountOfVertices;
+		physicsSurfaceResult_Local.amountOfVerticesPaintedAtMinAmount = randomStream_Local.RandRange(0, amountOfVertices);
+		physicsSurfaceResult_Local.averageColorAmountAtMinAmount = physicsSurfaceResult_Local.amountOfVerticesPaintedAtMinAmount * randomStream_Local.FRand();
+	}
+
+	return amountOfPaintedColorsOfEachChannel_Local;
+}
+
+
+//-------------------------------------------------------
+
+// Vertex Paint Kernels Benchmark
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVertexPaintKernelsBenchmark, "VertexPaint.Benchmarks.Kernels", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FVertexPaintKernelsBenchmark::RunTest(const FString& Parameters) {
+
+	const int32 amountOfVerticesToBenchmark_Local[] = { 1000, 16000, 256000, 1000000, 4000000 };
+	const float minColorAmountToBeConsidered_Local = 0.1f;
+
+	FVertexPaintBenchmark benchmark_Local;
+
+
+	for (int32 amountOfVertices_Local : amountOfVerticesToBenchmark_Local) {
+
+		const TArray<FColor> vertexColors_Local = MakeSyntheticVertexColors(amountOfVertices_Local);
+
+
+		benchmark_Local.Measure(TEXT("GetAmountOfPaintedColorsForEachChannel"), amountOfVertices_Local, [&]() {
+
+			VertexPaintFunctions::GetAmountOfPaintedColorsForEachChannel(vertexColors_Local, minColorAmountToBeConsidered_Local);
+		});
+
+
+		const FVertexDetectAmountOfPaintedColorsOfEachChannel amountOfPaintedColorsOfEachChannel_Local = VertexPaintFunctions::GetAmountOfPaintedColorsForEachChannel(vertexColors_Local, minColorAmountToBeConsidered_Local);
+
+		benchmark_Local.Measure(TEXT("ConsolidateColorsOfEachChannel"), amountOfVertices_Local, [&]() {
+
+			VertexPaintFunctions::ConsolidateColorsOfEachChannel(amountOfPaintedColorsOfEachChannel_Local, amountOfVertices_Local);
+		});
+
+
+		benchmark_Local.Measure(TEXT("GetColorChannelsHistogram"), amountOfVertices_Local, [&]() {
+
+			VertexPaintFunctions::GetColorChannelsHistogram(vertexColors_Local);
+		});
+
+
+		const FVertexColorChannelsHistogram colorChannelsHistogram_Local = VertexPaintFunctions::GetColorChannelsHistogram(vertexColors_Local);
+
+		benchmark_Local.Measure(TEXT("GetAmountOfPaintedColorsForEachChannelFromHistogram"), amountOfVertices_Local, [&]() {
+
+			VertexPaintFunctions::GetAmountOfPaintedColorsForEachChannelFromHistogram(colorChannelsHistogram_Local, minColorAmountToBeConsidered_Local);
+		});
+
+
+		const FVertexDetectAmountOfPaintedColorsOfEachChannel physicsSurfaceResults_Local = MakeSyntheticPhysicsSurfaceResults(amountOfVertices_Local);
+
+		benchmark_Local.Measure(TEXT("ConsolidatePhysicsSurfaceResult"), amountOfVertices_Local, [&]() {
+
+			VertexPaintFunctions::ConsolidatePhysicsSurfaceResult(physicsSurfaceResults_Local, amountOfVertices_Local);
+		});
+
+
+		FVertexDetectRankedPhysicsSurfaceResults rankedPhysicsSurfaceResults_Local;
+
+		benchmark_Local.Measure(TEXT("ConsolidatePhysicsSurfaceResultRanked"), amountOfVertices_Local, [&]() {
+
+			VertexPaintFunctions::ConsolidatePhysicsSurfaceResultRanked(physicsSurfaceResults_Local, amountOfVertices_Local, rankedPhysicsSurfaceResults_Local);
+		});
+
+
+		const FString serializedColors_Local = FVertexColorsSerializedString::Encode(vertexColors_Local);
+		TArray<FColor> decodedColors_Local;
+
+		benchmark_Local.Measure(TEXT("DecodeSerializedColors_Reference"), amountOfVertices_Local, [&]() {
+
+			FVertexColorsSerializedString::Decode_Reference(serializedColors_Local, decodedColors_Local);
+		});
+
+		benchmark_Local.Measure(TEXT("DecodeSerializedColors"), amountOfVertices_Local, [&]() {
+
+			FVertexColorsSerializedString::Decode(serializedColors_Local, decodedColors_Local);
+		});
+
+		// The fast path has to give the exact same colors as decoding them one at a time
+		TArray<FColor> referenceDecodedColors_Local;
+		FVertexColorsSerializedString::Decode_Reference(serializedColors_Local, referenceDecodedColors_Local);
+
+		if (decodedColors_Local != referenceDecodedColors_Local)
+			AddError(FString::Printf(TEXT("Decoding Serialized Colors with %i vertices gave different colors than the reference decoder"), amountOfVertices_Local));
+
+
+#if ENGINE_MAJOR_VERSION == 5
+
+		// Dynamic Meshes are the only mesh type where the readback can be measured without cooked render data, since their colors lives on the CPU
+		UDynamicMeshComponent* dynamicMeshComponent_Local = NewObject<UDynamicMeshComponent>(GetTransientPackage());
+
+		UE::Geometry::FDynamicMesh3 dynamicMesh3_Local(false, true, false, false);
+
+		for (int32 i = 0; i < amountOfVertices_Local; i++) {
+
+			const FLinearColor vertexLinearColor_Local = vertexColors_Local[i].ReinterpretAsLinear();
+			dynamicMesh3_Local.AppendVertex(UE::Geometry::FVertexInfo(FVector3d(i, 0, 0), FVector3f::ZAxisVector, FVector3f(vertexLinearColor_Local.R, vertexLinearColor_Local.G, vertexLinearColor_Local.B)));
+		}
+
+		dynamicMeshComponent_Local->GetDynamicMesh()->SetMesh(MoveTemp(dynamicMesh3_Local));
+
+		benchmark_Local.Measure(TEXT("GetDynamicMeshVertexColors"), amountOfVertices_Local, [&]() {
+
+			VertexPaintFunctions::GetDynamicMeshVertexColors(dynamicMeshComponent_Local);
+		});
+
+
+		// The read view and the into buffer readback converts straight into memory the caller already has, so these should allocate nothing after the first run
+		TArray<FColor> readbackBuffer_Local;
+		readbackBuffer_Local.SetNumUninitialized(amountOfVertices_Local);
+
+		benchmark_Local.Measure(TEXT("VertexColorsReadView_CopyTo"), amountOfVertices_Local, [&]() {
+
+			const FVertexColorsReadView vertexColorsReadView_Local = FVertexColorsReadView::Create(dynamicMeshComponent_Local, 0);
+
+			if (vertexColorsReadView_Local.Num() <= readbackBuffer_Local.Num())
+				vertexColorsReadView_Local.CopyTo(readbackBuffer_Local);
+		});
+
+		benchmark_Local.Measure(TEXT("GetMeshComponentVertexColorsAtLODIntoBuffer"), amountOfVertices_Local, [&]() {
+
+			VertexPaintFunctions::GetMeshComponentVertexColorsAtLODIntoBuffer(dynamicMeshComponent_Local, 0, readbackBuffer_Local);
+		});
+
+		if (readbackBuffer_Local != VertexPaintFunctions::GetDynamicMeshVertexColors(dynamicMeshComponent_Local))
+			AddError(FString::Printf(TEXT("Reading the colors of a Dynamic Mesh with %i vertices into a buffer gave different colors than Get Dynamic Mesh Vertex Colors"), amountOfVertices_Local));
+
+		dynamicMeshComponent_Local->MarkAsGarbage();
+#endif
+	}
+
+
+	const FString csv_Local = benchmark_Local.GetCSV();
+	const FString csvFilePath_Local = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("VertexPaintBenchmarks"), FString::Printf(TEXT("VertexPaintBenchmarks-%s.csv"), *FDateTime::Now().ToString()));
+
+	AddInfo(csv_Local);
+
+	if (!FFileHelper::SaveStringToFile(csv_Local, *csvFilePath_Local))
+		AddWarning(FString::Printf(TEXT("Failed to save Vertex Paint Benchmarks CSV to %s"), *csvFilePath_Local));
+	else
+		AddInfo(FString::Printf(TEXT("Saved Vertex Paint Benchmarks CSV to %s"), *csvFilePath_Local));
+
+	return true;
+}
+
+#endif
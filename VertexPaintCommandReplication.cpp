@@ -0,0 +1,445 @@
+#include "VertexPaintCommandReplication.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+#include "HAL/IConsoleManager.h"
+
+
+static TAutoConsoleVariable<int32> CVarVertexPaintReplicationCheckpointInterval(
+	TEXT("VertexPaint.Replication.CheckpointInterval"),
+	32,
+	TEXT("How many paint commands has to be applied on a component before a checkpoint with its colors is sent, which is roughly the most a peer that joins late has to replay. The checkpoint is taken when a task finishes, so it's of exactly the commands that has been applied even if more are queued. "),
+	ECVF_Default);
+
+
+//-------------------------------------------------------
+
+// Component Path
+
+// Relative to the world so it's the same on every peer, even in PIE where every world's package gets its own prefix
+static FString GetReplicatedComponentPath(const UPrimitiveComponent* meshComponent) {
+
+	return meshComponent->GetPathName(meshComponent->GetWorld());
+}
+
+
+//-------------------------------------------------------
+
+// Serialize Message Header
+
+static void SerializeReplicationMessageHeader(FArchive& archive, EVertexPaintReplicationMessageType& messageType, FString& componentPath, uint32& sequence) {
+
+	uint8 messageType_Local = static_cast<uint8>(messageType);
+
+	archive << messageType_Local;
+	archive << componentPath;
+	archive << sequence;
+
+	messageType = static_cast<EVertexPaintReplicationMessageType>(messageType_Local);
+}
+
+
+//-------------------------------------------------------
+
+// Get
+
+FVertexPaintCommandRecorder& FVertexPaintCommandRecorder::Get() {
+
+	static FVertexPaintCommandRecorder vertexPaintCommandRecorder;
+	return vertexPaintCommandRecorder;
+}
+
+
+//-------------------------------------------------------
+
+// Start Recording
+
+void FVertexPaintCommandRecorder::StartRecording(UWorld* world, TSharedPtr<IVertexPaintReplicationTransport> transport) {
+
+	StopRecording();
+
+	if (!IsValid(world) || !transport.IsValid()) return;
+
+	recordingId++;
+	recordingWorld = world;
+	recordingTransport = transport;
+}
+
+
+//-------------------------------------------------------
+
+// Stop Recording
+
+void FVertexPaintCommandRecorder::StopRecording() {
+
+	recordingWorld.Reset();
+	recordingTransport.Reset();
+	componentRecordings.Empty();
+}
+
+
+//-------------------------------------------------------
+
+// Record
+
+uint64 FVertexPaintCommandRecorder::RecordPaintOnMeshAtLocation(UPrimitiveComponent* meshComponent, const FVertexPaintAtLocationStruct& paintAtLocationStruct) {
+
+	return RecordCommand(meshComponent, EVertexPaintReplicatedCommandType::PaintAtLocation, FVertexPaintAtLocationStruct::StaticStruct(), &paintAtLocationStruct);
+}
+
+uint64 FVertexPaintCommandRecorder::RecordPaintOnMeshWithinArea(UPrimitiveComponent* meshComponent, const FVertexPainthWithinAreaStruct& paintWithinAreaStruct) {
+
+	return RecordCommand(meshComponent, EVertexPaintReplicatedCommandType::PaintWithinArea, FVertexPainthWithinAreaStruct::StaticStruct(), &paintWithinAreaStruct);
+}
+
+uint64 FVertexPaintCommandRecorder::RecordPaintOnEntireMesh(UPrimitiveComponent* meshComponent, const FVertexPaintOnEntireMeshStruct& paintOnEntireMeshStruct) {
+
+	// Every peer would pick different random vertices, so it only takes a sequence and the peers gets its colors with the checkpoint taken when it has been applied
+	if (paintOnEntireMeshStruct.paintOnRandomVerticesSettings.paintAtRandomVerticesSpreadOutOverTheEntireMesh) {
+
+		FComponentRecording* componentRecording_Local = FindRecordingToRecordOn(meshComponent);
+
+		if (!componentRecording_Local) return 0;
+
+		const uint32 sequence_Local = componentRecording_Local->nextSequence++;
+
+		componentRecording_Local->unreplicatedSequences.Add(sequence_Local);
+		componentRecording_Local->commandMessagesSinceCheckpoint.AddDefaulted();
+
+		return GetReplicatedCommandId(sequence_Local);
+	}
+
+	return RecordCommand(meshComponent, EVertexPaintReplicatedCommandType::PaintOnEntireMesh, FVertexPaintOnEntireMeshStruct::StaticStruct(), &paintOnEntireMeshStruct);
+}
+
+
+FVertexPaintCommandRecorder::FComponentRecording* FVertexPaintCommandRecorder::FindRecordingToRecordOn(UPrimitiveComponent* meshComponent) {
+
+	if (isReplaying) return nullptr;
+	if (!recordingTransport.IsValid() || !recordingWorld.IsValid()) return nullptr;
+	if (!IsValid(meshComponent) || meshComponent->GetWorld() != recordingWorld.Get()) return nullptr;
+
+	return &componentRecordings.FindOrAdd(meshComponent);
+}
+
+
+uint64 FVertexPaintCommandRecorder::RecordCommand(UPrimitiveComponent* meshComponent, EVertexPaintReplicatedCommandType commandType, UScriptStruct* settingsStruct, const void* settings) {
+
+	FComponentRecording* componentRecordingPtr_Local = FindRecordingToRecordOn(meshComponent);
+
+	if (!componentRecordingPtr_Local) return 0;
+
+	FComponentRecording& componentRecording_Local = *componentRecordingPtr_Local;
+
+
+	EVertexPaintReplicationMessageType messageType_Local = EVertexPaintReplicationMessageType::PaintCommand;
+	FString componentPath_Local = GetReplicatedComponentPath(meshComponent);
+	uint32 sequence_Local = componentRecording_Local.nextSequence++;
+	uint8 commandType_Local = static_cast<uint8>(commandType);
+
+	TArray<uint8> replicationMessage_Local;
+	FMemoryWriter memoryWriter_Local(replicationMessage_Local);
+
+	SerializeReplicationMessageHeader(memoryWriter_Local, messageType_Local, componentPath_Local, sequence_Local);
+	memoryWriter_Local << commandType_Local;
+
+	// Object references in the settings, e.g. physics materials and data assets, are written as their paths so they resolve on the other peers
+	FObjectAndNameAsStringProxyArchive settingsWriter_Local(memoryWriter_Local, false);
+	settingsStruct->SerializeBin(settingsWriter_Local, const_cast<void*>(settings));
+
+
+	componentRecording_Local.commandMessagesSinceCheckpoint.Add(replicationMessage_Local);
+	recordingTransport->SendReplicationMessage(replicationMessage_Local);
+
+	return GetReplicatedCommandId(sequence_Local);
+}
+
+
+//-------------------------------------------------------
+
+// Record Paint Task Finished
+
+void FVertexPaintCommandRecorder::RecordPaintTaskFinished(UPrimitiveComponent* meshComponent, uint64 replicatedCommandId) {
+
+	if (!recordingTransport.IsValid() || !recordingWorld.IsValid()) return;
+
+	// Tasks that wasn't recorded, or was recorded before the recording was restarted
+	if (replicatedCommandId == 0 || static_cast<uint32>(replicatedCommandId >> 32) != recordingId) return;
+
+	FComponentRecording* componentRecording_Local = componentRecordings.Find(meshComponent);
+	const uint32 finishedSequence_Local = static_cast<uint32>(replicatedCommandId);
+
+	if (!componentRecording_Local || finishedSequence_Local < componentRecording_Local->appliedSequence || finishedSequence_Local >= componentRecording_Local->nextSequence) return;
+
+
+	// Only moves the applied sequence past commands that has all finished, so a checkpoint never claims one that hasn't
+	componentRecording_Local->finishedSequences.Add(finishedSequence_Local);
+
+	bool appliedUnreplicatedPaint_Local = false;
+
+	while (componentRecording_Local->finishedSequences.Remove(componentRecording_Local->appliedSequence) > 0) {
+
+		if (componentRecording_Local->unreplicatedSequences.Remove(componentRecording_Local->appliedSequence) > 0)
+			appliedUnreplicatedPaint_Local = true;
+
+		componentRecording_Local->appliedSequence++;
+	}
+
+	if (appliedUnreplicatedPaint_Local) {
+
+		// The peers are waiting at this sequence until they get its colors
+		if (!RecordCheckpoint(meshComponent, *componentRecording_Local))
+			UE_LOG(LogTemp, Warning, TEXT("VertexPaint - Couldn't take a Replication Checkpoint after Paint on Entire Mesh at random vertices, so peers will wait for the next one before replaying any more paint on %s"), *meshComponent->GetName());
+
+		return;
+	}
+
+	const int32 checkpointInterval_Local = CVarVertexPaintReplicationCheckpointInterval.GetValueOnGameThread();
+
+	if (checkpointInterval_Local > 0 && componentRecording_Local->appliedSequence - componentRecording_Local->lastCheckpointSequence >= static_cast<uint32>(checkpointInterval_Local))
+		RecordCheckpoint(meshComponent, *componentRecording_Local);
+}
+
+
+//-------------------------------------------------------
+
+// Record Checkpoint
+
+bool FVertexPaintCommandRecorder::RecordCheckpoint(UPrimitiveComponent* meshComponent, FComponentRecording& componentRecording) {
+
+	TArray<uint8> binaryColorData_Local;
+
+	if (!VertexPaintFunctions::GetMeshComponentVertexColorsAsBinary(meshComponent, true, binaryColorData_Local)) return false;
+
+
+	// The checkpoint is the colors with every command before the applied sequence in them, so replay continues from it
+	EVertexPaintReplicationMessageType messageType_Local = EVertexPaintReplicationMessageType::Checkpoint;
+	FString componentPath_Local = GetReplicatedComponentPath(meshComponent);
+	uint32 sequence_Local = componentRecording.appliedSequence;
+
+	TArray<uint8> replicationMessage_Local;
+	FMemoryWriter memoryWriter_Local(replicationMessage_Local);
+
+	SerializeReplicationMessageHeader(memoryWriter_Local, messageType_Local, componentPath_Local, sequence_Local);
+	memoryWriter_Local << binaryColorData_Local;
+
+
+	// Commands that were recorded but hasn't been applied yet aren't in the checkpoint, so they're kept for peers that catches up from it
+	const int32 amountOfCommandsInCheckpoint_Local = FMath::Min<int32>(componentRecording.appliedSequence - componentRecording.lastCheckpointSequence, componentRecording.commandMessagesSinceCheckpoint.Num());
+
+	if (amountOfCommandsInCheckpoint_Local > 0)
+		componentRecording.commandMessagesSinceCheckpoint.RemoveAt(0, amountOfCommandsInCheckpoint_Local);
+
+	componentRecording.lastCheckpointMessage = replicationMessage_Local;
+	componentRecording.lastCheckpointSequence = componentRecording.appliedSequence;
+
+	recordingTransport->SendReplicationMessage(replicationMessage_Local);
+
+	return true;
+}
+
+
+//-------------------------------------------------------
+
+// Get Catch Up Messages
+
+void FVertexPaintCommandRecorder::GetCatchUpMessages(UPrimitiveComponent* meshComponent, TArray<TArray<uint8>>& catchUpMessages) const {
+
+	catchUpMessages.Reset();
+
+	const FComponentRecording* componentRecording_Local = componentRecordings.Find(meshComponent);
+
+	if (!componentRecording_Local) return;
+
+
+	if (componentRecording_Local->lastCheckpointMessage.Num() > 0)
+		catchUpMessages.Add(componentRecording_Local->lastCheckpointMessage);
+
+	// Skips the unreplicated ones, which the peer gets with the checkpoint after them
+	for (const TArray<uint8>& commandMessageTemp : componentRecording_Local->commandMessagesSinceCheckpoint) {
+
+		if (commandMessageTemp.Num() > 0)
+			catchUpMessages.Add(commandMessageTemp);
+	}
+}
+
+
+//-------------------------------------------------------
+
+// Replayer
+
+FVertexPaintCommandReplayer::FVertexPaintCommandReplayer(UWorld* world, UVertexPaintDetectionComponent* paintComponent) : replayWorld(world), replayPaintComponent(paintComponent) {
+
+}
+
+
+//-------------------------------------------------------
+
+// Receive Replication Message
+
+void FVertexPaintCommandReplayer::ReceiveReplicationMessage(const TArray<uint8>& replicationMessage) {
+
+	if (!replayWorld.IsValid()) return;
+
+
+	FMemoryReader memoryReader_Local(replicationMessage);
+
+	EVertexPaintReplicationMessageType messageType_Local = EVertexPaintReplicationMessageType::PaintCommand;
+	FString componentPath_Local;
+	uint32 sequence_Local = 0;
+
+	SerializeReplicationMessageHeader(memoryReader_Local, messageType_Local, componentPath_Local, sequence_Local);
+
+	if (memoryReader_Local.IsError()) return;
+
+
+	UPrimitiveComponent* meshComponent_Local = FindObject<UPrimitiveComponent>(replayWorld.Get(), *componentPath_Local);
+
+	if (!IsValid(meshComponent_Local)) return;
+
+	FComponentReplay& componentReplay_Local = componentReplays.FindOrAdd(componentPath_Local);
+
+
+	if (messageType_Local == EVertexPaintReplicationMessageType::Checkpoint) {
+
+		// Already past it, which means we have every command it has in it
+		if (sequence_Local < componentReplay_Local.nextSequence) return;
+
+		TArray<uint8> binaryColorData_Local;
+		memoryReader_Local << binaryColorData_Local;
+
+		if (memoryReader_Local.IsError()) return;
+
+
+		ApplyCheckpoint(meshComponent_Local, binaryColorData_Local);
+
+		// Commands before the checkpoint are in its colors, so they're not needed anymore even if they never arrived
+		componentReplay_Local.nextSequence = sequence_Local;
+
+		for (auto it = componentReplay_Local.bufferedCommands.CreateIterator(); it; ++it) {
+
+			if (it.Key() < sequence_Local)
+				it.RemoveCurrent();
+		}
+
+		ReplayBufferedCommands(meshComponent_Local, componentReplay_Local);
+		return;
+	}
+
+
+	// Duplicate, or one that a checkpoint already has in it
+	if (sequence_Local < componentReplay_Local.nextSequence) return;
+
+	uint8 commandType_Local = 0;
+	memoryReader_Local << commandType_Local;
+
+	if (memoryReader_Local.IsError()) return;
+
+
+	// Holds on to the rest of the message, i.e. the settings, until every command before it has been replayed
+	FBufferedCommand bufferedCommand_Local;
+	bufferedCommand_Local.commandType = static_cast<EVertexPaintReplicatedCommandType>(commandType_Local);
+	bufferedCommand_Local.serializedSettings.Append(replicationMessage.GetData() + memoryReader_Local.Tell(), replicationMessage.Num() - memoryReader_Local.Tell());
+
+	componentReplay_Local.bufferedCommands.Add(sequence_Local, MoveTemp(bufferedCommand_Local));
+
+	ReplayBufferedCommands(meshComponent_Local, componentReplay_Local);
+}
+
+
+//-------------------------------------------------------
+
+// Replay Buffered Commands
+
+void FVertexPaintCommandReplayer::ReplayBufferedCommands(UPrimitiveComponent* meshComponent, FComponentReplay& componentReplay) {
+
+	FBufferedCommand bufferedCommand_Local;
+
+	while (componentReplay.bufferedCommands.RemoveAndCopyValue(componentReplay.nextSequence, bufferedCommand_Local)) {
+
+		ReplayCommand(meshComponent, bufferedCommand_Local.commandType, bufferedCommand_Local.serializedSettings);
+		componentReplay.nextSequence++;
+	}
+}
+
+
+//-------------------------------------------------------
+
+// Replay Command
+
+void FVertexPaintCommandReplayer::ReplayCommand(UPrimitiveComponent* meshComponent, EVertexPaintReplicatedCommandType commandType, const TArray<uint8>& serializedSettings) {
+
+	UVertexPaintDetectionComponent* paintComponent_Local = replayPaintComponent.Get();
+
+	if (!IsValid(paintComponent_Local)) return;
+
+
+	FMemoryReader memoryReader_Local(serializedSettings);
+	FObjectAndNameAsStringProxyArchive settingsReader_Local(memoryReader_Local, false);
+
+	FVertexPaintCommandRecorder::FScopedReplay scopedReplay_Local;
+
+	// The wrappers sets the mesh component and everything that depends on the world, so it's the peer's own and not what was recorded
+	switch (commandType) {
+
+	case EVertexPaintReplicatedCommandType::PaintAtLocation: {
+
+		FVertexPaintAtLocationStruct paintAtLocationStruct_Local;
+		FVertexPaintAtLocationStruct::StaticStruct()->SerializeBin(settingsReader_Local, &paintAtLocationStruct_Local);
+
+		VertexPaintFunctions::PaintOnMeshAtLocation_Wrapper(paintComponent_Local, meshComponent, paintAtLocationStruct_Local, FVertexDetectAdditionalDataToPassThrough());
+		break;
+	}
+
+	case EVertexPaintReplicatedCommandType::PaintWithinArea: {
+
+		FVertexPainthWithinAreaStruct paintWithinAreaStruct_Local;
+		FVertexPainthWithinAreaStruct::StaticStruct()->SerializeBin(settingsReader_Local, &paintWithinAreaStruct_Local);
+
+		VertexPaintFunctions::PaintOnMeshWithinArea_Wrapper(paintComponent_Local, meshComponent, paintWithinAreaStruct_Local.componentsToCheckIfIsWithin, paintWithinAreaStruct_Local, FVertexDetectAdditionalDataToPassThrough());
+		break;
+	}
+
+	case EVertexPaintReplicatedCommandType::PaintOnEntireMesh: {
+
+		FVertexPaintOnEntireMeshStruct paintOnEntireMeshStruct_Local;
+		FVertexPaintOnEntireMeshStruct::StaticStruct()->SerializeBin(settingsReader_Local, &paintOnEntireMeshStruct_Local);
+
+		VertexPaintFunctions::PaintOnEntireMesh_Wrapper(paintComponent_Local, meshComponent, paintOnEntireMeshStruct_Local, FVertexDetectAdditionalDataToPassThrough());
+		break;
+	}
+
+	default:
+		break;
+	}
+}
+
+
+//-------------------------------------------------------
+
+// Apply Checkpoint
+
+void FVertexPaintCommandReplayer::ApplyCheckpoint(UPrimitiveComponent* meshComponent, const TArray<uint8>& binaryColorData) {
+
+	FVertexPaintCommandRecorder::FScopedReplay scopedReplay_Local;
+	VertexPaintFunctions::SetMeshComponentVertexColorsFromBinary_Wrapper(meshComponent, binaryColorData, FVertexPaintSetMeshComponentVertexColors(), FVertexDetectAdditionalDataToPassThrough());
+}
+
+
+//-------------------------------------------------------
+
+// Deliver Messages
+
+void FVertexPaintLoopbackTransport::DeliverMessages() {
+
+	// Swapped out first in case the replay records and sends more
+	TArray<TArray<uint8>> messagesToDeliver_Local = MoveTemp(queuedMessages);
+	queuedMessages.Reset();
+
+	if (!loopbackReplayer.IsValid()) return;
+
+	for (const TArray<uint8>& messageTemp : messagesToDeliver_Local)
+		loopbackReplayer->ReceiveReplicationMessage(messageTemp);
+}
@@ -0,0 +1,196 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+#include "VertexPaintFunctionLibrary.h"
+
+class UPrimitiveComponent;
+class UVertexPaintDetectionComponent;
+class UWorld;
+
+
+//-------------------------------------------------------
+
+// Vertex Paint Command Replication
+
+// Instead of sending whole color arrays to keep clients in sync, the paint tasks settings are recorded per component in the order they were requested and replayed on each peer, so every peer runs the same tasks on the same colors. Every so often a checkpoint with the component's colors is sent as well, so a peer that joins late or missed commands only has to replay the ones since the last checkpoint. 
+// Paint on Entire Mesh at random vertices isn't replicated as a command since each peer would pick different vertices. It still takes a sequence but nothing is sent for it, so the peers waits at it like it was dropped, until the checkpoint that is taken once it has been applied. 
+// Messages are just bytes, so they can be sent over whatever the game uses for networking. The Loopback Transport delivers them to a Replayer in the same process, so it can be tested without a network. 
+
+enum class EVertexPaintReplicationMessageType : uint8 {
+
+	PaintCommand = 0,
+	Checkpoint = 1,
+};
+
+enum class EVertexPaintReplicatedCommandType : uint8 {
+
+	PaintAtLocation = 0,
+	PaintWithinArea = 1,
+	PaintOnEntireMesh = 2,
+};
+
+
+class IVertexPaintReplicationTransport {
+
+public:
+
+	virtual ~IVertexPaintReplicationTransport() = default;
+
+	virtual void SendReplicationMessage(const TArray<uint8>& replicationMessage) = 0;
+};
+
+
+//-------------------------------------------------------
+
+// Vertex Paint Command Recorder
+
+class FVertexPaintCommandRecorder {
+
+public:
+
+	static FVertexPaintCommandRecorder& Get();
+
+	// Records paint on components in the world and sends it with the transport
+	void StartRecording(UWorld* world, TSharedPtr<IVertexPaintReplicationTransport> transport);
+
+	void StopRecording();
+
+	// Run by the paint wrappers before they start the task. Returns the id of the recorded command, or 0 if it wasn't recorded, which the wrappers passes along with the task in its Additional Data so the callback can tell us which command it was. 
+	uint64 RecordPaintOnMeshAtLocation(UPrimitiveComponent* meshComponent, const FVertexPaintAtLocationStruct& paintAtLocationStruct);
+
+	uint64 RecordPaintOnMeshWithinArea(UPrimitiveComponent* meshComponent, const FVertexPainthWithinAreaStruct& paintWithinAreaStruct);
+
+	uint64 RecordPaintOnEntireMesh(UPrimitiveComponent* meshComponent, const FVertexPaintOnEntireMeshStruct& paintOnEntireMeshStruct);
+
+	// Run by the Paint at Location, Within Area and Entire Mesh callbacks with the id the task was recorded with. Tasks that wasn't recorded, e.g. ones queued before we started recording or by running the paint functions on the component directly, has 0 and are ignored, so they can't make a checkpoint claim a command has been applied when it hasn't. This is also where checkpoints are taken. 
+	void RecordPaintTaskFinished(UPrimitiveComponent* meshComponent, uint64 replicatedCommandId);
+
+	// The last checkpoint and every command since it, for a peer that joins late
+	void GetCatchUpMessages(UPrimitiveComponent* meshComponent, TArray<TArray<uint8>>& catchUpMessages) const;
+
+	// While replaying, the paint the replayer runs shouldn't be recorded and sent back
+	struct FScopedReplay {
+
+		FScopedReplay() { Get().isReplaying = true; }
+		~FScopedReplay() { Get().isReplaying = false; }
+	};
+
+
+private:
+
+	struct FComponentRecording {
+
+		uint32 nextSequence = 0;
+
+		// Every command before this has been applied to the component's colors
+		uint32 appliedSequence = 0;
+
+		// Commands after the applied sequence that has finished before one that was recorded before them
+		TSet<uint32> finishedSequences;
+
+		// Paint that wasn't sent as a command, so a checkpoint has to be taken when it's applied
+		TSet<uint32> unreplicatedSequences;
+
+		TArray<uint8> lastCheckpointMessage;
+		uint32 lastCheckpointSequence = 0;
+
+		// Starts at lastCheckpointSequence, so commands that were recorded before the checkpoint was taken but applied after it are kept. Empty for the unreplicated ones. 
+		TArray<TArray<uint8>> commandMessagesSinceCheckpoint;
+	};
+
+	uint64 RecordCommand(UPrimitiveComponent* meshComponent, EVertexPaintReplicatedCommandType commandType, UScriptStruct* settingsStruct, const void* settings);
+
+	// The recording in the upper half so tasks recorded before a restart of the recording can't be taken for ones recorded after it
+	uint64 GetReplicatedCommandId(uint32 sequence) const { return (static_cast<uint64>(recordingId) << 32) | sequence; }
+
+	FComponentRecording* FindRecordingToRecordOn(UPrimitiveComponent* meshComponent);
+
+	bool RecordCheckpoint(UPrimitiveComponent* meshComponent, FComponentRecording& componentRecording);
+
+
+	TWeakObjectPtr<UWorld> recordingWorld;
+	uint32 recordingId = 0;
+	TSharedPtr<IVertexPaintReplicationTransport> recordingTransport;
+
+	TMap<TWeakObjectPtr<UPrimitiveComponent>, FComponentRecording> componentRecordings;
+
+	bool isReplaying = false;
+};
+
+
+//-------------------------------------------------------
+
+// Vertex Paint Command Replayer
+
+// Replays the messages on the peer's components in sequence order. Commands that arrive early are held until the ones before them has arrived, or a checkpoint makes them unnecessary. 
+
+class FVertexPaintCommandReplayer {
+
+public:
+
+	// paintComponent is the peer's own Vertex Paint Component that the replayed tasks are run with
+	FVertexPaintCommandReplayer(UWorld* world, UVertexPaintDetectionComponent* paintComponent);
+
+	virtual ~FVertexPaintCommandReplayer() = default;
+
+	void ReceiveReplicationMessage(const TArray<uint8>& replicationMessage);
+
+
+protected:
+
+	// Runs the tasks. Virtual so tests can see what gets replayed without running any. 
+	virtual void ReplayCommand(UPrimitiveComponent* meshComponent, EVertexPaintReplicatedCommandType commandType, const TArray<uint8>& serializedSettings);
+
+	virtual void ApplyCheckpoint(UPrimitiveComponent* meshComponent, const TArray<uint8>& binaryColorData);
+
+
+private:
+
+	struct FBufferedCommand {
+
+		EVertexPaintReplicatedCommandType commandType = EVertexPaintReplicatedCommandType::PaintAtLocation;
+		TArray<uint8> serializedSettings;
+	};
+
+	struct FComponentReplay {
+
+		uint32 nextSequence = 0;
+		TMap<uint32, FBufferedCommand> bufferedCommands;
+	};
+
+	void ReplayBufferedCommands(UPrimitiveComponent* meshComponent, FComponentReplay& componentReplay);
+
+
+	TWeakObjectPtr<UWorld> replayWorld;
+	TWeakObjectPtr<UVertexPaintDetectionComponent> replayPaintComponent;
+
+	TMap<FString, FComponentReplay> componentReplays;
+};
+
+
+//-------------------------------------------------------
+
+// Vertex Paint Loopback Transport
+
+// Stand in for the network layer. Holds on to what's sent until Deliver Messages is run, so tests can also deliver them out of order or drop some to see that the replayer recovers. 
+
+class FVertexPaintLoopbackTransport : public IVertexPaintReplicationTransport {
+
+public:
+
+	explicit FVertexPaintLoopbackTransport(TSharedPtr<FVertexPaintCommandReplayer> replayer) : loopbackReplayer(replayer) {}
+
+	virtual void SendReplicationMessage(const TArray<uint8>& replicationMessage) override { queuedMessages.Add(replicationMessage); }
+
+	void DeliverMessages();
+
+	TArray<TArray<uint8>>& GetQueuedMessages() { return queuedMessages; }
+
+
+private:
+
+	TSharedPtr<FVertexPaintCommandReplayer> loopbackReplayer;
+
+	TArray<TArray<uint8>> queuedMessages;
+};
@@ -9,10 +9,27 @@
 #include "Materials/MaterialInstance.h"
 #include "PhysicsEngine/BodySetup.h"
 #include "Engine/GameInstance.h"
+#include "HAL/IConsoleManager.h"
+#include "Async/ParallelFor.h"
+#include "Containers/Ticker.h"
 
 #include "Runtime/Engine/Classes/Engine/LatentActionManager.h"
-#include "ColorsOfEachChannelLatentAction.h"
-#include "ColorsOfEachChannelAsyncTask.h"
+#include "ColorsOfEachChannelRequest.h"
+#include "VertexColorChannelsHistogram.h"
+#include "VertexColorChannelsStatsCache.h"
+#include "VertexDetectRankedPhysicsSurfaceResults.h"
+#include "VertexPositionSpatialIndex.h"
+#include "VertexColorsReadView.h"
+#include "VertexColorsReadback.h"
+#include "VertexColorsSnapshotDedupCache.h"
+#include "VertexColorsGenerations.h"
+#include "VertexColorsColdStorage.h"
+#include "VertexColorChannelPlanes.h"
+#include "VertexColorsBinaryFormat.h"
+#include "VertexColorsSerializedString.h"
+#include "VertexPaintSnapshot.h"
+#include "VertexColorsPatch.h"
+#include "VertexPaintCommandReplication.h"
 
 #include "Engine/StaticMesh.h"
 #include "StaticMeshResources.h"
@@ -68,6 +85,27 @@ void VertexPaintFunctions::PrintTaskLog(FVertexPaintDebugSettings debugSettings,
 }
 
 
+//--------------------------------------------------------
+
+// Warm Up Component Before Task
+
+// The tasks reads and writes the components override colors directly, so if they've been compressed into cold storage they're decompressed back here on the Game Thread before the task is queued, otherwise painting would start from the GPU only buffers. 
+// Components in a snapshot that is being restored gets their restore queued first, so the task runs on top of the snapshot colors instead of having them Set over what it did later. Tasks that Sets every color, like Set Mesh Component Vertex Colors, replaces the snapshot colors anyway so the component is just taken out of the snapshot. 
+
+static void WarmUpComponentBeforeTask(UPrimitiveComponent* meshComponent, bool setsAllColors = false) {
+
+	if (!IsValid(meshComponent)) return;
+
+	if (setsAllColors)
+		FVertexPaintSnapshotRestore::Get().RemoveComponentIfPending(meshComponent);
+	else
+		FVertexPaintSnapshotRestore::Get().RestoreComponentIfPending(meshComponent);
+
+	FVertexColorsColdStorage::Get().MarkUsed(meshComponent);
+	FVertexColorsColdStorage::Get().WarmUp(meshComponent);
+}
+
+
 //--------------------------------------------------------
 
 // Get Closest Vertex Data On Mesh Wrapper
@@ -80,6 +118,8 @@ void VertexPaintFunctions::GetClosestVertexDataOnMesh_Wrapper(UVertexPaintDetect
 
 		// Note nothing more should be set here, because if a C++ Class calls the Paint/Detection Function Right Away it shouldn't lose out on anything being set
 
+		WarmUpComponentBeforeTask(meshComponent);
+
 		VertexPaintComp->GetClosestVertexDataOnMesh(getClosestVertexDataStruct, additionalDataToPassThrough);
 	}
 
@@ -102,6 +142,8 @@ void VertexPaintFunctions::GetAllVertexColorsOnly_Wrapper(UVertexPaintDetectionC
 
 		// Note nothing more should be set here, because if a C++ Class calls the Paint/Detection Function Right Away it shouldn't lose out on anything being set
 
+		WarmUpComponentBeforeTask(meshComponent);
+
 		VertexPaintComp->GetAllVertexColorsOnly(getAllVertexColorsStruct, additionalDataToPassThrough);
 	}
 
@@ -124,6 +166,11 @@ void VertexPaintFunctions::PaintOnMeshAtLocation_Wrapper(UVertexPaintDetectionCo
 
 		// Note nothing more should be set here, because if a C++ Class calls the Paint/Detection Function Right Away it shouldn't lose out on anything being set
 
+		WarmUpComponentBeforeTask(meshComponent);
+
+		// If replicating paint commands this is sent to the other peers so they run the same task. The id goes along with the task so its callback can tell the recorder exactly which command finished. 
+		additionalDataToPassThrough.replicatedCommandId = FVertexPaintCommandRecorder::Get().RecordPaintOnMeshAtLocation(meshComponent, paintAtLocationStruct);
+
 		VertexPaintComp->PaintOnMeshAtLocation(paintAtLocationStruct, additionalDataToPassThrough);
 	}
 
@@ -147,6 +194,10 @@ void VertexPaintFunctions::PaintOnMeshWithinArea_Wrapper(UVertexPaintDetectionCo
 
 		// Note nothing more should be set here, because if a C++ Class calls the Paint/Detection Function Right Away it shouldn't lose out on anything being set
 
+		WarmUpComponentBeforeTask(meshComponent);
+
+		additionalDataToPassThrough.replicatedCommandId = FVertexPaintCommandRecorder::Get().RecordPaintOnMeshWithinArea(meshComponent, paintWithinAreaStruct);
+
 		VertexPaintComp->PaintOnMeshWithinArea(paintWithinAreaStruct, additionalDataToPassThrough);
 	}
 
@@ -169,6 +220,10 @@ void VertexPaintFunctions::PaintOnEntireMesh_Wrapper(UVertexPaintDetectionCompon
 
 		// Note nothing more should be set here, because if a C++ Class calls the Paint/Detection Function Right Away it shouldn't lose out on anything being set
 
+		WarmUpComponentBeforeTask(meshComponent);
+
+		additionalDataToPassThrough.replicatedCommandId = FVertexPaintCommandRecorder::Get().RecordPaintOnEntireMesh(meshComponent, paintOnEntireMeshStruct);
+
 		VertexPaintComp->PaintOnEntireMesh(paintOnEntireMeshStruct, additionalDataToPassThrough);
 	}
 
@@ -191,6 +246,8 @@ void VertexPaintFunctions::PaintColorSnippetOnMesh_Wrappers(UVertexPaintDetectio
 
 		// Note nothing more should be set here, because if a C++ Class calls the Paint/Detection Function Right Away it shouldn't lose out on anything being set
 
+		WarmUpComponentBeforeTask(meshComponent);
+
 		VertexPaintComp->PaintColorSnippetOnMesh(paintColorSnippetStruct, additionalDataToPassThrough);
 	}
 
@@ -271,8 +328,13 @@ void VertexPaintFunctions::SetMeshComponentVertexColors_Wrapper(UPrimitiveCompon
 	}
 
 
+	WarmUpComponentBeforeTask(setMeshComponentVertexColorsSettings.meshComponent, true);
+
 	if (VertexPaintFunctions::GetVertexPaintTaskQueue(setMeshComponentVertexColorsSettings.meshComponent->GetWorld()))
 		VertexPaintFunctions::GetVertexPaintTaskQueue(setMeshComponentVertexColorsSettings.meshComponent->GetWorld())->AddCalculateColorsTaskToQueue(calculateColorsInfoTemp);
+
+	// Every LOD gets Set so anything cached from the current colors is out of date
+	FVertexColorsGenerations::Get().BumpGenerationOfAllLODs(setMeshComponentVertexColorsSettings.meshComponent);
 }
 
 
@@ -341,8 +403,328 @@ void VertexPaintFunctions::SetMeshComponentVertexColorsUsingSerializedString_Wra
 		return;
 	}
 
+	WarmUpComponentBeforeTask(setMeshComponentVertexColorsUsingSerializedStringSettings.meshComponent, true);
+
 	if (VertexPaintFunctions::GetVertexPaintTaskQueue(setMeshComponentVertexColorsUsingSerializedStringSettings.meshComponent->GetWorld()))
 		VertexPaintFunctions::GetVertexPaintTaskQueue(setMeshComponentVertexColorsUsingSerializedStringSettings.meshComponent->GetWorld())->AddCalculateColorsTaskToQueue(calculateColorsInfoTemp);
+
+	FVertexColorsGenerations::Get().BumpGenerationOfAllLODs(setMeshComponentVertexColorsUsingSerializedStringSettings.meshComponent);
+}
+
+
+//--------------------------------------------------------
+
+// Binary Vertex Colors
+
+static TAutoConsoleVariable<int32> CVarVertexPaintBinaryColorsCompression(
+	TEXT("VertexPaint.BinaryColors.Compression"),
+#if ENGINE_MAJOR_VERSION == 5
+	2,
+#else
+	1,
+#endif
+	TEXT("What Get Mesh Component Vertex Colors As Binary compresses the colors with. 0 is None, 1 is LZ4 and 2 is Oodle, which is only available in UE5. Decoding handles all of them no matter what this is set to. "),
+	ECVF_Default);
+
+
+// The colors the source mesh itself has at LOD0, which binary colors can be delta encoded against. Empty if they aren't available on the CPU, in which case the colors are stored as they are. 
+static void GetSourceMeshDefaultColorsAtLOD0(UPrimitiveComponent* meshComponent, TArray<FColor>& sourceMeshColors) {
+
+	sourceMeshColors.Reset();
+
+	if (!IsValid(meshComponent)) return;
+
+
+	FColorVertexBuffer* defaultColorVertexBuffer_Local = nullptr;
+	int32 amountOfVertices_Local = 0;
+
+	if (UStaticMeshComponent* staticMeshComponent = Cast<UStaticMeshComponent>(meshComponent)) {
+
+		UStaticMesh* staticMesh_Local = staticMeshComponent->GetStaticMesh();
+
+		if (!IsValid(staticMesh_Local) || !staticMesh_Local->GetRenderData() || !staticMesh_Local->GetRenderData()->LODResources.IsValidIndex(0)) return;
+
+		defaultColorVertexBuffer_Local = &staticMesh_Local->GetRenderData()->LODResources[0].VertexBuffers.ColorVertexBuffer;
+		amountOfVertices_Local = staticMesh_Local->GetRenderData()->LODResources[0].GetNumVertices();
+	}
+
+	else if (USkeletalMeshComponent* skeletalMeshComponent = Cast<USkeletalMeshComponent>(meshComponent)) {
+
+		if (!skeletalMeshComponent->GetSkeletalMeshRenderData() || !skeletalMeshComponent->GetSkeletalMeshRenderData()->LODRenderData.IsValidIndex(0)) return;
+
+		defaultColorVertexBuffer_Local = &skeletalMeshComponent->GetSkeletalMeshRenderData()->LODRenderData[0].StaticVertexBuffers.ColorVertexBuffer;
+		amountOfVertices_Local = skeletalMeshComponent->GetSkeletalMeshRenderData()->LODRenderData[0].GetNumVertices();
+	}
+
+	if (!defaultColorVertexBuffer_Local || amountOfVertices_Local <= 0) return;
+
+
+	if (defaultColorVertexBuffer_Local->GetVertexData() && defaultColorVertexBuffer_Local->GetNumVertices() == static_cast<uint32>(amountOfVertices_Local)) {
+
+		defaultColorVertexBuffer_Local->GetVertexColors(sourceMeshColors);
+	}
+
+	// Same as when getting the colors, meshes that was imported with all White and never painted can have nothing in their color buffer
+	else if (!defaultColorVertexBuffer_Local->IsInitialized() || defaultColorVertexBuffer_Local->GetNumVertices() == 0) {
+
+		sourceMeshColors.Init(FColor::White, amountOfVertices_Local);
+	}
+}
+
+
+// How many vertices the component has at LOD0, without reading any colors. 0 if it's a type we can't tell or has no render data. 
+static int32 GetMeshComponentAmountOfVerticesAtLOD0(UPrimitiveComponent* meshComponent) {
+
+	if (!IsValid(meshComponent)) return 0;
+
+
+	if (UStaticMeshComponent* staticMeshComponent = Cast<UStaticMeshComponent>(meshComponent)) {
+
+		UStaticMesh* staticMesh_Local = staticMeshComponent->GetStaticMesh();
+
+		if (!IsValid(staticMesh_Local) || !staticMesh_Local->GetRenderData() || !staticMesh_Local->GetRenderData()->LODResources.IsValidIndex(0)) return 0;
+
+		return staticMesh_Local->GetRenderData()->LODResources[0].GetNumVertices();
+	}
+
+	else if (USkeletalMeshComponent* skeletalMeshComponent = Cast<USkeletalMeshComponent>(meshComponent)) {
+
+		if (!skeletalMeshComponent->GetSkeletalMeshRenderData() || !skeletalMeshComponent->GetSkeletalMeshRenderData()->LODRenderData.IsValidIndex(0)) return 0;
+
+		return skeletalMeshComponent->GetSkeletalMeshRenderData()->LODRenderData[0].GetNumVertices();
+	}
+
+#if ENGINE_MAJOR_VERSION == 5
+
+	else if (UDynamicMeshComponent* dynamicMeshComponent = Cast<UDynamicMeshComponent>(meshComponent)) {
+
+		return VertexPaintFunctions::GetDynamicMeshAmountOfVertexColors(dynamicMeshComponent);
+	}
+
+	else if (UGeometryCollectionComponent* geometryCollectionComponent = Cast<UGeometryCollectionComponent>(meshComponent)) {
+
+		return VertexPaintFunctions::GetGeometryCollectionAmountOfVertexColors(geometryCollectionComponent);
+	}
+
+#endif
+
+	return 0;
+}
+
+
+bool VertexPaintFunctions::GetMeshComponentVertexColorsAsBinary(UPrimitiveComponent* meshComponent, bool deltaEncodeAgainstSourceMeshColors, TArray<uint8>& binaryColorDataAtLOD0) {
+
+	binaryColorDataAtLOD0.Reset();
+
+	if (!IsValid(meshComponent)) return false;
+
+
+	const FVertexColorsReadView vertexColorsReadView_Local = GetMeshComponentVertexColorsReadViewAtLOD(meshComponent, 0);
+
+	if (vertexColorsReadView_Local.Num() <= 0) return false;
+
+	TArray<FColor> sourceMeshColors_Local;
+
+	if (deltaEncodeAgainstSourceMeshColors)
+		GetSourceMeshDefaultColorsAtLOD0(meshComponent, sourceMeshColors_Local);
+
+	const EVertexColorsBinaryCompression compression_Local = static_cast<EVertexColorsBinaryCompression>(FMath::Clamp(CVarVertexPaintBinaryColorsCompression.GetValueOnAnyThread(), 0, 2));
+
+	return FVertexColorsBinaryFormat::Encode(vertexColorsReadView_Local.GetColors(), GetMeshComponentSourceMesh(meshComponent), sourceMeshColors_Local, compression_Local, binaryColorDataAtLOD0);
+}
+
+
+bool VertexPaintFunctions::GetVertexColorsFromBinary(UPrimitiveComponent* meshComponent, const TArray<uint8>& binaryColorDataAtLOD0, TArray<FColor>& vertexColorsAtLOD0) {
+
+	vertexColorsAtLOD0.Reset();
+
+	if (!IsValid(meshComponent)) return false;
+
+
+	FVertexColorsBinaryHeader header_Local;
+
+	if (!FVertexColorsBinaryFormat::ReadHeader(binaryColorDataAtLOD0, header_Local)) return false;
+
+	// Checked before anything is allocated for the colors, so a corrupt or crafted header can't make us allocate up to 2GB for a mesh that has a fraction of that many vertices
+	if (header_Local.amountOfVertices != GetMeshComponentAmountOfVerticesAtLOD0(meshComponent)) return false;
+
+	// Only needs the source mesh's colors if they were delta encoded against them
+	TArray<FColor> sourceMeshColors_Local;
+
+	if (header_Local.IsDeltaEncoded())
+		GetSourceMeshDefaultColorsAtLOD0(meshComponent, sourceMeshColors_Local);
+
+	return FVertexColorsBinaryFormat::Decode(binaryColorDataAtLOD0, GetMeshComponentSourceMesh(meshComponent), sourceMeshColors_Local, vertexColorsAtLOD0);
+}
+
+
+//--------------------------------------------------------
+
+// Set Mesh Component Vertex Colors From Binary
+
+void VertexPaintFunctions::SetMeshComponentVertexColorsFromBinary_Wrapper(UPrimitiveComponent* meshComponent, const TArray<uint8>& binaryColorDataAtLOD0, FVertexPaintSetMeshComponentVertexColors setMeshComponentVertexColorsSettings, FVertexDetectAdditionalDataToPassThrough additionalDataToPassThrough) {
+
+	// Decodes straight into the color array of the task, which is then moved along with the settings, so it's the same as Set Mesh Component Vertex Colors without ever having the colors as a string
+	if (!GetVertexColorsFromBinary(meshComponent, binaryColorDataAtLOD0, setMeshComponentVertexColorsSettings.vertexColorsAtLOD0ToSet)) {
+
+		// Still runs it with the empty array so it fails its checks and the callbacks gets run as with any other failed task
+		VertexPaintFunctions::PrintTaskLog(setMeshComponentVertexColorsSettings.debugSettings, FString::Printf(TEXT("VertexPaint - Trying to Set Mesh Component Vertex Colors From Binary but the data couldn't be decoded. It may be for another mesh, from a newer version, or delta encoded against colors the source mesh doesn't have available on the CPU. ")), FColor::Red);
+	}
+
+	SetMeshComponentVertexColors_Wrapper(meshComponent, MoveTemp(setMeshComponentVertexColorsSettings), additionalDataToPassThrough);
+}
+
+
+//--------------------------------------------------------
+
+// Get Vertex Colors From Serialized String
+
+bool VertexPaintFunctions::GetVertexColorsFromSerializedString(const FString& serializedColorData, TArray<FColor>& vertexColors) {
+
+	// Large strings are decoded in parallel chunks straight into the array, which is allocated once for all of them
+	return FVertexColorsSerializedString::Decode(serializedColorData, vertexColors);
+}
+
+
+//--------------------------------------------------------
+
+// Vertex Colors Patches
+
+bool VertexPaintFunctions::GetMeshComponentVertexColorsPatch(UPrimitiveComponent* meshComponent, int lod, const TArray<FColor>& referenceColors, TArray<uint8>& patch) {
+
+	patch.Reset();
+
+	// Compares against the colors where they are, so the only thing allocated is the patch itself
+	const FVertexColorsReadView vertexColorsReadView_Local = GetMeshComponentVertexColorsReadViewAtLOD(meshComponent, lod);
+
+	if (vertexColorsReadView_Local.Num() <= 0) return false;
+
+	return FVertexColorsPatch::Compute(referenceColors, vertexColorsReadView_Local.GetColors(), patch);
+}
+
+
+bool VertexPaintFunctions::GetVertexColorsPatch(const TArray<FColor>& fromColors, const TArray<FColor>& toColors, TArray<uint8>& patch) {
+
+	return FVertexColorsPatch::Compute(fromColors, toColors, patch);
+}
+
+
+bool VertexPaintFunctions::ApplyVertexColorsPatch(TArray<FColor>& vertexColors, const TArray<uint8>& patch) {
+
+	return FVertexColorsPatch::Apply(vertexColors, patch);
+}
+
+
+//--------------------------------------------------------
+
+// Set Mesh Component Vertex Colors Using Patch
+
+static void SetMeshComponentVertexColorsUsingPatchNow(UPrimitiveComponent* meshComponent, const TArray<uint8>& patchAtLOD0, FVertexPaintSetMeshComponentVertexColors setMeshComponentVertexColorsSettings, const FVertexDetectAdditionalDataToPassThrough& additionalDataToPassThrough) {
+
+	// Reads the current colors straight into the task's color array and patches them in place, so only the changed vertices are written before it's Set the same as Set Mesh Component Vertex Colors
+	const bool patched_Local = VertexPaintFunctions::GetMeshComponentVertexColorsAtLODIntoBuffer(meshComponent, 0, setMeshComponentVertexColorsSettings.vertexColorsAtLOD0ToSet) && FVertexColorsPatch::Apply(setMeshComponentVertexColorsSettings.vertexColorsAtLOD0ToSet, patchAtLOD0);
+
+	if (!patched_Local) {
+
+		// Still runs it with the empty array so it fails its checks and the callbacks gets run as with any other failed task
+		setMeshComponentVertexColorsSettings.vertexColorsAtLOD0ToSet.Empty();
+
+		VertexPaintFunctions::PrintTaskLog(setMeshComponentVertexColorsSettings.debugSettings, FString::Printf(TEXT("VertexPaint - Trying to Set Mesh Component Vertex Colors Using Patch but it couldn't be applied. It may be for a mesh with another amount of vertices, made from other colors than the mesh has, or be corrupt. ")), FColor::Red);
+	}
+
+	VertexPaintFunctions::SetMeshComponentVertexColors_Wrapper(meshComponent, MoveTemp(setMeshComponentVertexColorsSettings), additionalDataToPassThrough);
+}
+
+
+#if ENGINE_MAJOR_VERSION == 5
+
+// Patches that came in while their component had paint or set tasks queued. They're applied in the order they came in, each once the tasks on its component has finished. 
+struct FPendingVertexColorsPatch {
+
+	TWeakObjectPtr<UPrimitiveComponent> meshComponent;
+	TArray<uint8> patchAtLOD0;
+	FVertexPaintSetMeshComponentVertexColors setMeshComponentVertexColorsSettings;
+	FVertexDetectAdditionalDataToPassThrough additionalDataToPassThrough;
+};
+
+static TArray<FPendingVertexColorsPatch> PendingVertexColorsPatches;
+static FTSTicker::FDelegateHandle PendingVertexColorsPatchesTickerHandle;
+
+static bool TickPendingVertexColorsPatches(float deltaTime) {
+
+	TSet<UPrimitiveComponent*> componentsStillWaiting_Local;
+
+	for (int32 i = 0; i < PendingVertexColorsPatches.Num(); i++) {
+
+		UPrimitiveComponent* meshComponent_Local = PendingVertexColorsPatches[i].meshComponent.Get();
+
+		// Later patches on a component waits for the earlier ones, so they're applied in order
+		if (componentsStillWaiting_Local.Contains(meshComponent_Local)) continue;
+
+		if (IsValid(meshComponent_Local) && VertexPaintFunctions::GetCalculateColorsPaintTasksAmount_Wrapper(meshComponent_Local).FindRef(meshComponent_Local) > 0) {
+
+			componentsStillWaiting_Local.Add(meshComponent_Local);
+			continue;
+		}
+
+
+		FPendingVertexColorsPatch pendingPatch_Local = MoveTemp(PendingVertexColorsPatches[i]);
+		PendingVertexColorsPatches.RemoveAt(i--);
+
+		// If the component is gone the Set fails its checks and runs the callbacks like any other failed task
+		SetMeshComponentVertexColorsUsingPatchNow(meshComponent_Local, pendingPatch_Local.patchAtLOD0, MoveTemp(pendingPatch_Local.setMeshComponentVertexColorsSettings), pendingPatch_Local.additionalDataToPassThrough);
+
+		// The Set we just queued counts as a paint task on the component, so any more patches for it waits until it has run
+		componentsStillWaiting_Local.Add(meshComponent_Local);
+	}
+
+	if (PendingVertexColorsPatches.Num() > 0) return true;
+
+	PendingVertexColorsPatchesTickerHandle.Reset();
+	return false;
+}
+
+#endif
+
+void VertexPaintFunctions::SetMeshComponentVertexColorsUsingPatch_Wrapper(UPrimitiveComponent* meshComponent, const TArray<uint8>& patchAtLOD0, FVertexPaintSetMeshComponentVertexColors setMeshComponentVertexColorsSettings, FVertexDetectAdditionalDataToPassThrough additionalDataToPassThrough) {
+
+	// The patch was made from the colors the mesh has once the paint and set tasks queued before it has run, so if there are any it's held until they've finished and applied to the colors they left, the same as if it had been a task queued after them. The base hash in the patch makes it fail instead of overwriting the colors if they still aren't the ones it was made from. 
+#if ENGINE_MAJOR_VERSION == 5
+
+	bool hasPendingPatches_Local = false;
+
+	for (const FPendingVertexColorsPatch& pendingPatchTemp : PendingVertexColorsPatches) {
+
+		if (pendingPatchTemp.meshComponent == meshComponent)
+			hasPendingPatches_Local = true;
+	}
+
+	if (IsValid(meshComponent) && (hasPendingPatches_Local || GetCalculateColorsPaintTasksAmount_Wrapper(meshComponent).FindRef(meshComponent) > 0)) {
+
+		PendingVertexColorsPatches.Add({ meshComponent, patchAtLOD0, MoveTemp(setMeshComponentVertexColorsSettings), additionalDataToPassThrough });
+
+		if (!PendingVertexColorsPatchesTickerHandle.IsValid())
+			PendingVertexColorsPatchesTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&TickPendingVertexColorsPatches));
+
+		return;
+	}
+
+#else
+
+	// Without the core ticker to wait on there's no way to apply it once they're done, so it's rejected and has to be sent again
+	if (IsValid(meshComponent) && GetCalculateColorsPaintTasksAmount_Wrapper(meshComponent).FindRef(meshComponent) > 0) {
+
+		setMeshComponentVertexColorsSettings.vertexColorsAtLOD0ToSet.Empty();
+
+		VertexPaintFunctions::PrintTaskLog(setMeshComponentVertexColorsSettings.debugSettings, FString::Printf(TEXT("VertexPaint - Trying to Set Mesh Component Vertex Colors Using Patch on Component: %s but it has Paint Tasks queued, so the colors the patch would be applied to isn't final yet. "), *meshComponent->GetName()), FColor::Red);
+
+		SetMeshComponentVertexColors_Wrapper(meshComponent, MoveTemp(setMeshComponentVertexColorsSettings), additionalDataToPassThrough);
+		return;
+	}
+
+#endif
+
+	SetMeshComponentVertexColorsUsingPatchNow(meshComponent, patchAtLOD0, MoveTemp(setMeshComponentVertexColorsSettings), additionalDataToPassThrough);
 }
 
 
@@ -483,6 +865,32 @@ TMap<UPrimitiveComponent*, int> VertexPaintFunctions::GetMeshPaintedSinceSession
 }
 
 
+//--------------------------------------------------------
+
+// Write Vertex Paint Snapshot
+
+bool VertexPaintFunctions::WriteVertexPaintSnapshot_Wrapper(const UObject* WorldContextObject, const FString& snapshotFilePath, int& amountOfComponentsWritten) {
+
+	int32 amountOfComponentsWritten_Local = 0;
+	const bool writtenSuccessfully_Local = FVertexPaintSnapshot::WriteWorldSnapshot(WorldContextObject, snapshotFilePath, amountOfComponentsWritten_Local);
+
+	amountOfComponentsWritten = amountOfComponentsWritten_Local;
+
+	return writtenSuccessfully_Local;
+}
+
+
+//--------------------------------------------------------
+
+// Restore Vertex Paint Snapshot
+
+bool VertexPaintFunctions::RestoreVertexPaintSnapshot_Wrapper(const UObject* WorldContextObject, const FString& snapshotFilePath, FVertexPaintSetMeshComponentVertexColors setMeshComponentVertexColorsSettings) {
+
+	// Only reads the index here, the components gets their colors when they're streamed in, queried, or a few at a time in the background
+	return FVertexPaintSnapshotRestore::Get().OpenSnapshot(WorldContextObject, snapshotFilePath, setMeshComponentVertexColorsSettings);
+}
+
+
 //--------------------------------------------------------
 
 // Clear Mesh Painted Since Session Started
@@ -997,31 +1405,22 @@ void VertexPaintFunctions::VertexPaintFunctionsLib_SetStaticMeshAndReleaseOverri
 
 
 			int amountOfVertsToSwitchTo = 0;
-			TArray<FColor> colorLOD_Local;
+			FColor colorToSwitchTo_Local = FColor(0, 0, 0, 0);
 
 			if (newMesh->GetRenderData()->LODResources.IsValidIndex(i)) {
 
 				amountOfVertsToSwitchTo = newMesh->GetRenderData()->LODResources[i].GetNumVertices();
 				auto colVertBufferAtLOD_Local = &newMesh->GetRenderData()->LODResources[i].VertexBuffers.ColorVertexBuffer;
 
-				// If color buffer isn't initialized it means its default colors are White and it hasn't been painted either in editor or in runtime, if this is the case we init the array with white so even unstored, unpainted cpu meshes with all default white vertex colors can be painted and look as they should. 
-				if (colVertBufferAtLOD_Local) {
-
-					if (colVertBufferAtLOD_Local->IsInitialized())
-						colorLOD_Local.Init(FColor(0, 0, 0, 0), amountOfVertsToSwitchTo);
-					else
-						colorLOD_Local.Init(FColor::White, amountOfVertsToSwitchTo);
-				}
-
-				else {
-
-					colorLOD_Local.Init(FColor::White, amountOfVertsToSwitchTo);
-				}
+				// If color buffer isn't initialized it means its default colors are White and it hasn't been painted either in editor or in runtime, if this is the case we init with white so even unstored, unpainted cpu meshes with all default white vertex colors can be painted and look as they should. 
+				if (!colVertBufferAtLOD_Local || !colVertBufferAtLOD_Local->IsInitialized())
+					colorToSwitchTo_Local = FColor::White;
 			}
 
 			// Had to make a new color vertex buffer and init it, otherwise when switching mesh, the new mesh could get really weird colors, as if the old buffer "bleed" to the next mesh but where the vertex color didn't match since it's a new mesh with different vertex amount etc. 
 			staticMeshComponent->LODData[i].OverrideVertexColors = new FColorVertexBuffer();
-			staticMeshComponent->LODData[i].OverrideVertexColors->InitFromColorArray(colorLOD_Local);
+			// Every vertex gets the same color so the buffer is filled directly instead of going through a temporary array of them
+			staticMeshComponent->LODData[i].OverrideVertexColors->InitFromSingleColor(colorToSwitchTo_Local, amountOfVertsToSwitchTo);
 			BeginInitResource(staticMeshComponent->LODData[i].OverrideVertexColors);
 		}
 	}
@@ -1030,6 +1429,13 @@ void VertexPaintFunctions::VertexPaintFunctionsLib_SetStaticMeshAndReleaseOverri
 
 	staticMeshComponent->MarkRenderStateDirty();
 
+	// Cached stats was for the previous mesh's colors
+	FVertexColorChannelsStatsCache::Get().RemoveComponent(staticMeshComponent);
+	FVertexColorsSnapshotDedupCache::Get().RemoveComponent(staticMeshComponent);
+	FVertexColorsColdStorage::Get().RemoveComponent(staticMeshComponent);
+	FVertexColorChannelPlanesCache::Get().RemoveComponent(staticMeshComponent);
+	FVertexColorsGenerations::Get().BumpGenerationOfAllLODs(staticMeshComponent);
+
 
 }
 
@@ -1101,6 +1507,13 @@ void VertexPaintFunctions::VertexPaintFunctionsLib_SetSkeletalMeshAndReleaseReso
 #endif
 
 #endif
+
+	// Cached stats was for the previous mesh's colors
+	FVertexColorChannelsStatsCache::Get().RemoveComponent(skeletalMeshComponent);
+	FVertexColorsSnapshotDedupCache::Get().RemoveComponent(skeletalMeshComponent);
+	FVertexColorsColdStorage::Get().RemoveComponent(skeletalMeshComponent);
+	FVertexColorChannelPlanesCache::Get().RemoveComponent(skeletalMeshComponent);
+	FVertexColorsGenerations::Get().BumpGenerationOfAllLODs(skeletalMeshComponent);
 }
 
 
@@ -1205,96 +1618,878 @@ void VertexPaintFunctions::DrawPrimitiveComponentBoundsBox(UPrimitiveComponent*
 
 //--------------------------------------------------------
 
-// Get Amount Of Painted Colors For Each Channel - Async Version
+// Get Amount Of Painted Colors For Each Channel - Async Version
+
+void VertexPaintFunctions::GetAmountOfPaintedColorsForEachChannelAsync(UObject* WorldContextObject, FLatentActionInfo LatentInfo, const TArray<FColor>& vertexColors, float minColorAmountToBeConsidered, FVertexDetectAmountOfPaintedColorsOfEachChannel& amountOfColorsOfEachChannel) {
+
+	// Blueprint owns the array it sends in so it has to be copied into a snapshot once. From C++ you can use the snapshot version directly and skip the copy. 
+	GetAmountOfPaintedColorsForEachChannelAsync(WorldContextObject, LatentInfo, MakeVertexColorsSnapshot(vertexColors), minColorAmountToBeConsidered, amountOfColorsOfEachChannel);
+}
+
+void VertexPaintFunctions::GetAmountOfPaintedColorsForEachChannelAsync(UObject* WorldContextObject, FLatentActionInfo LatentInfo, FVertexColorsSnapshotRef vertexColors, float minColorAmountToBeConsidered, FVertexDetectAmountOfPaintedColorsOfEachChannel& amountOfColorsOfEachChannel) {
+
+	if (!IsValid(WorldContextObject)) return;
+
+
+	if (UWorld* World = WorldContextObject->GetWorld()) {
+
+		FLatentActionManager& latentActionManager_Local = World->GetLatentActionManager();
+
+		// Every node gets its own Request so many actors can have one in flight at the same time, but the same node can't start another until its previous one is finished, same as other latent nodes. 
+		if (latentActionManager_Local.FindExistingAction<FColorsOfEachChannelRequestLatentAction>(LatentInfo.CallbackTarget, LatentInfo.UUID)) {
+
+			UE_LOG(LogTemp, Log, TEXT("Trying to Start GetAmountOfPaintedColorsForEachChannelAsync but this node already has a Request awaiting to be Finished!"));
+			return;
+		}
+
+
+		// The Request gets queued on the worker pool right away, and the latent action Cancels it if it gets Aborted or destroyed before it's finished
+		TSharedRef<FColorsOfEachChannelRequest, ESPMode::ThreadSafe> colorsOfEachChannelRequest_Local = FColorsOfEachChannelRequest::Start(vertexColors, minColorAmountToBeConsidered);
+
+		latentActionManager_Local.AddNewAction(LatentInfo.CallbackTarget, LatentInfo.UUID, new FColorsOfEachChannelRequestLatentAction(LatentInfo, colorsOfEachChannelRequest_Local, amountOfColorsOfEachChannel));
+	}
+}
+
+
+//--------------------------------------------------------
+
+// Colors Of Each Channel Byte Kernel
+
+static TAutoConsoleVariable<int32> CVarVertexPaintColorsOfEachChannelUseVectorizedKernel(
+	TEXT("VertexPaint.ColorsOfEachChannel.UseVectorizedKernel"),
+	1,
+	TEXT("If 1, Get Amount Of Painted Colors For Each Channel compares and sums the raw FColor bytes with the vectorized kernel on platforms that supports it. If 0 the scalar kernel is used. "),
+	ECVF_Default);
+
+
+static TAutoConsoleVariable<int32> CVarVertexPaintColorsOfEachChannelParallelVertexThreshold(
+	TEXT("VertexPaint.ColorsOfEachChannel.ParallelVertexThreshold"),
+	262144,
+	TEXT("Color arrays with at least this many vertices gets split into chunks that are counted in parallel with ParallelFor when running Get Amount Of Painted Colors For Each Channel. 0 or less means it always runs on one thread. "),
+	ECVF_Default);
+
+
+// Amount of vertices that passed the min amount and the sum of their bytes for each channel in the order R, G, B, A. Kept as integers so we can count on the raw bytes and merge partial results without losing any precision. 
+struct FColorsOfEachChannelByteCounts {
+
+	int64 amountOfVerticesPaintedAtMinAmount[4] = { 0, 0, 0, 0 };
+	int64 colorAmountSumAtMinAmount[4] = { 0, 0, 0, 0 };
+
+	void Merge(const FColorsOfEachChannelByteCounts& otherByteCounts) {
+
+		for (int i = 0; i < 4; i++) {
+
+			amountOfVerticesPaintedAtMinAmount[i] += otherByteCounts.amountOfVerticesPaintedAtMinAmount[i];
+			colorAmountSumAtMinAmount[i] += otherByteCounts.colorAmountSumAtMinAmount[i];
+		}
+	}
+};
+
+
+// Converts the min color amount to the lowest byte that passes the exact same check we did before with ReinterpretAsLinear, i.e. byte / 255 >= minColorAmountToBeConsidered, so the result is identical to the float compare. Returns 256 if no byte can pass it. 
+static uint32 GetColorsOfEachChannelByteThreshold(float minColorAmountToBeConsidered) {
+
+	for (uint32 byteValue = 0; byteValue <= 255; byteValue++) {
+
+		if (FColor(0, 0, 0, static_cast<uint8>(byteValue)).ReinterpretAsLinear().A >= minColorAmountToBeConsidered)
+			return byteValue;
+	}
+
+	return 256;
+}
+
+
+static void CountColorsOfEachChannel_Scalar(const FColor* vertexColors, int32 amountOfVertexColors, uint32 byteThreshold, FColorsOfEachChannelByteCounts& byteCounts) {
+
+	for (int32 i = 0; i < amountOfVertexColors; i++) {
+
+		const FColor& colorTemp = vertexColors[i];
+
+		const int64 redPassed_Local = colorTemp.R >= byteThreshold;
+		const int64 greenPassed_Local = colorTemp.G >= byteThreshold;
+		const int64 bluePassed_Local = colorTemp.B >= byteThreshold;
+		const int64 alphaPassed_Local = colorTemp.A >= byteThreshold;
+
+		byteCounts.amountOfVerticesPaintedAtMinAmount[0] += redPassed_Local;
+		byteCounts.amountOfVerticesPaintedAtMinAmount[1] += greenPassed_Local;
+		byteCounts.amountOfVerticesPaintedAtMinAmount[2] += bluePassed_Local;
+		byteCounts.amountOfVerticesPaintedAtMinAmount[3] += alphaPassed_Local;
+
+		byteCounts.colorAmountSumAtMinAmount[0] += redPassed_Local * colorTemp.R;
+		byteCounts.colorAmountSumAtMinAmount[1] += greenPassed_Local * colorTemp.G;
+		byteCounts.colorAmountSumAtMinAmount[2] += bluePassed_Local * colorTemp.B;
+		byteCounts.colorAmountSumAtMinAmount[3] += alphaPassed_Local * colorTemp.A;
+	}
+}
+
+
+#if ENGINE_MAJOR_VERSION == 5 && PLATFORM_ENABLE_VECTORINTRINSICS
+
+template<int32 ChannelBitShift>
+FORCEINLINE void CountColorsOfEachChannel_VectorizedChannel(const VectorRegister4Int& colorsRegister, const VectorRegister4Int& byteMask, const VectorRegister4Int& byteThresholdMinusOne, VectorRegister4Int& amountPaintedAccumulator, VectorRegister4Int& colorSumAccumulator) {
+
+	const VectorRegister4Int channelBytes_Local = VectorIntAnd(VectorShiftRightImmLogical(colorsRegister, ChannelBitShift), byteMask);
+	const VectorRegister4Int passedMask_Local = VectorIntCompareGT(channelBytes_Local, byteThresholdMinusOne);
+
+	// Passed lanes are all bits set, i.e. -1, so subtracting the mask adds 1 to every lane that passed
+	amountPaintedAccumulator = VectorIntSubtract(amountPaintedAccumulator, passedMask_Local);
+	colorSumAccumulator = VectorIntAdd(colorSumAccumulator, VectorIntAnd(channelBytes_Local, passedMask_Local));
+}
+
+static void CountColorsOfEachChannel_Vectorized(const FColor* vertexColors, int32 amountOfVertexColors, uint32 byteThreshold, FColorsOfEachChannelByteCounts& byteCounts) {
+
+	// FColor is stored as B, G, R, A so when 4 colors are loaded into a register as 4 uint32, B is the lowest byte and A the highest. We run 4 registers each iteration so 16 vertices gets compared at a time. 
+	const VectorRegister4Int byteMask_Local = VectorIntSet1(0xFF);
+	const VectorRegister4Int byteThresholdMinusOne_Local = VectorIntSet1(static_cast<int32>(byteThreshold) - 1);
+
+	const int32 verticesPerIteration_Local = 16;
+	const int32 amountOfIterations_Local = amountOfVertexColors / verticesPerIteration_Local;
+
+	// Each lane can get at most 4 * 255 added to its sum every iteration, so we flush the lanes to the int64 counts well before they could overflow
+	const int32 maxIterationsBeforeFlush_Local = 1 << 20;
+
+
+	int32 iteration_Local = 0;
+
+	while (iteration_Local < amountOfIterations_Local) {
+
+		VectorRegister4Int amountPainted_Local[4] = { GlobalVectorConstants::IntZero, GlobalVectorConstants::IntZero, GlobalVectorConstants::IntZero, GlobalVectorConstants::IntZero };
+		VectorRegister4Int colorSum_Local[4] = { GlobalVectorConstants::IntZero, GlobalVectorConstants::IntZero, GlobalVectorConstants::IntZero, GlobalVectorConstants::IntZero };
+
+		const int32 lastIterationBeforeFlush_Local = FMath::Min(amountOfIterations_Local, iteration_Local + maxIterationsBeforeFlush_Local);
+
+		for (; iteration_Local < lastIterationBeforeFlush_Local; iteration_Local++) {
+
+			const FColor* colorsAtIteration_Local = vertexColors + iteration_Local * verticesPerIteration_Local;
+
+			for (int32 registerIndex = 0; registerIndex < 4; registerIndex++) {
+
+				const VectorRegister4Int colorsRegister_Local = VectorIntLoad(colorsAtIteration_Local + registerIndex * 4);
+
+				CountColorsOfEachChannel_VectorizedChannel<16>(colorsRegister_Local, byteMask_Local, byteThresholdMinusOne_Local, amountPainted_Local[0], colorSum_Local[0]);
+				CountColorsOfEachChannel_VectorizedChannel<8>(colorsRegister_Local, byteMask_Local, byteThresholdMinusOne_Local, amountPainted_Local[1], colorSum_Local[1]);
+				CountColorsOfEachChannel_VectorizedChannel<0>(colorsRegister_Local, byteMask_Local, byteThresholdMinusOne_Local, amountPainted_Local[2], colorSum_Local[2]);
+				CountColorsOfEachChannel_VectorizedChannel<24>(colorsRegister_Local, byteMask_Local, byteThresholdMinusOne_Local, amountPainted_Local[3], colorSum_Local[3]);
+			}
+		}
+
+
+		int32 amountPaintedLanes_Local[4];
+		int32 colorSumLanes_Local[4];
+
+		for (int channelIndex = 0; channelIndex < 4; channelIndex++) {
+
+			VectorIntStore(amountPainted_Local[channelIndex], amountPaintedLanes_Local);
+			VectorIntStore(colorSum_Local[channelIndex], colorSumLanes_Local);
+
+			for (int laneIndex = 0; laneIndex < 4; laneIndex++) {
+
+				byteCounts.amountOfVerticesPaintedAtMinAmount[channelIndex] += amountPaintedLanes_Local[laneIndex];
+				byteCounts.colorAmountSumAtMinAmount[channelIndex] += colorSumLanes_Local[laneIndex];
+			}
+		}
+	}
+
+
+	// Whatever is left that didn't fill up a whole iteration
+	const int32 amountOfVerticesCounted_Local = amountOfIterations_Local * verticesPerIteration_Local;
+
+	CountColorsOfEachChannel_Scalar(vertexColors + amountOfVerticesCounted_Local, amountOfVertexColors - amountOfVerticesCounted_Local, byteThreshold, byteCounts);
+}
+
+#endif
+
+
+static void CountColorsOfEachChannel(const FColor* vertexColors, int32 amountOfVertexColors, uint32 byteThreshold, FColorsOfEachChannelByteCounts& byteCounts) {
+
+	if (amountOfVertexColors <= 0) return;
+
+	// If the min amount is above 1 then no byte can pass so there's nothing to count
+	if (byteThreshold > 255) return;
+
+
+#if ENGINE_MAJOR_VERSION == 5 && PLATFORM_ENABLE_VECTORINTRINSICS
+
+	if (CVarVertexPaintColorsOfEachChannelUseVectorizedKernel.GetValueOnAnyThread() != 0) {
+
+		CountColorsOfEachChannel_Vectorized(vertexColors, amountOfVertexColors, byteThreshold, byteCounts);
+		return;
+	}
+
+#endif
+
+	CountColorsOfEachChannel_Scalar(vertexColors, amountOfVertexColors, byteThreshold, byteCounts);
+}
+
+
+// For views of meshes that has never been painted, where every vertex has the same color, so it's the same as counting them one by one but without looking at them
+static void CountUniformColorOfEachChannel(const FColor& uniformColor, int32 amountOfVertexColors, uint32 byteThreshold, FColorsOfEachChannelByteCounts& byteCounts) {
+
+	if (amountOfVertexColors <= 0) return;
+
+	const uint32 channelBytes_Local[4] = { uniformColor.R, uniformColor.G, uniformColor.B, uniformColor.A };
+
+	for (int i = 0; i < 4; i++) {
+
+		if (channelBytes_Local[i] < byteThreshold) continue;
+
+		byteCounts.amountOfVerticesPaintedAtMinAmount[i] += amountOfVertexColors;
+		byteCounts.colorAmountSumAtMinAmount[i] += static_cast<int64>(channelBytes_Local[i]) * amountOfVertexColors;
+	}
+}
+
+
+// Splits the colors into chunks of 64k vertices, i.e. 256kb which fits in the L2 cache, that gets counted with ParallelFor into their own partial counts which are then merged. Since the partial counts are integers the merged result is exactly the same as if we had counted everything on one thread. 
+static void CountColorsOfEachChannel_Parallel(const FColor* vertexColors, int32 amountOfVertexColors, uint32 byteThreshold, FColorsOfEachChannelByteCounts& byteCounts) {
+
+	const int32 verticesPerChunk_Local = 64 * 1024;
+	const int32 amountOfChunks_Local = FMath::DivideAndRoundUp(amountOfVertexColors, verticesPerChunk_Local);
+
+	TArray<FColorsOfEachChannelByteCounts> chunksByteCounts_Local;
+	chunksByteCounts_Local.SetNum(amountOfChunks_Local);
+
+
+	ParallelFor(amountOfChunks_Local, [&](int32 chunkIndex) {
+
+		const int32 chunkStartIndex_Local = chunkIndex * verticesPerChunk_Local;
+		const int32 amountOfVerticesInChunk_Local = FMath::Min(verticesPerChunk_Local, amountOfVertexColors - chunkStartIndex_Local);
+
+		// Counts into a local first so the workers aren't writing to the same cache lines in the array while counting
+		FColorsOfEachChannelByteCounts chunkByteCounts_Local;
+		CountColorsOfEachChannel(vertexColors + chunkStartIndex_Local, amountOfVerticesInChunk_Local, byteThreshold, chunkByteCounts_Local);
+
+		chunksByteCounts_Local[chunkIndex] = chunkByteCounts_Local;
+	});
+
+
+	for (const FColorsOfEachChannelByteCounts& chunkByteCountsTemp : chunksByteCounts_Local)
+		byteCounts.Merge(chunkByteCountsTemp);
+}
+
+
+// Fills the Channel Results from the byte counts so it's in the same state as if we had accumulated it vertex by vertex, so ConsolidateColorsOfEachChannel can be run on it afterwards. 
+static FVertexDetectAmountOfPaintedColorsOfEachChannel GetAmountOfPaintedColorsOfEachChannelFromByteCounts(const FColorsOfEachChannelByteCounts& byteCounts, int32 amountOfVertices) {
+
+	FVertexDetectAmountOfPaintedColorsOfEachChannel amountOfPaintedColorsOfEachChannel_Local;
+
+	FVertexDetectAmountOfPaintedColorsOfEachChannel_Results* channelResults_Local[4] = {
+
+		&amountOfPaintedColorsOfEachChannel_Local.redChannelResult,
+		&amountOfPaintedColorsOfEachChannel_Local.greenChannelResult,
+		&amountOfPaintedColorsOfEachChannel_Local.blueChannelResult,
+		&amountOfPaintedColorsOfEachChannel_Local.alphaChannelResult
+	};
+
+	for (int i = 0; i < 4; i++) {
+
+		channelResults_Local[i]->amountOfVerticesConsidered = amountOfVertices;
+		channelResults_Local[i]->amountOfVerticesPaintedAtMinAmount = byteCounts.amountOfVerticesPaintedAtMinAmount[i];
+		channelResults_Local[i]->averageColorAmountAtMinAmount = static_cast<float>(static_cast<double>(byteCounts.colorAmountSumAtMinAmount[i]) / 255.0);
+	}
+
+	return amountOfPaintedColorsOfEachChannel_Local;
+}
+
+
+//--------------------------------------------------------
+
+// Get Amount Of Painted Colors For Each Channel
+
+FVertexDetectAmountOfPaintedColorsOfEachChannel VertexPaintFunctions::GetAmountOfPaintedColorsForEachChannel(const TArray<FColor>& vertexColors, float minColorAmountToBeConsidered) {
+
+	if (vertexColors.Num() <= 0) return FVertexDetectAmountOfPaintedColorsOfEachChannel();
+
+
+	// Compares and sums on the raw FColor bytes instead of running ReinterpretAsLinear and float compares for every vertex. The min amount gets converted to a byte threshold once that gives the exact same result as the float compare. 
+	FColorsOfEachChannelByteCounts byteCounts_Local;
+	const uint32 byteThreshold_Local = GetColorsOfEachChannelByteThreshold(minColorAmountToBeConsidered);
+	const int32 parallelVertexThreshold_Local = CVarVertexPaintColorsOfEachChannelParallelVertexThreshold.GetValueOnAnyThread();
+
+	// Large meshes gets counted in chunks over all cores
+	if (parallelVertexThreshold_Local > 0 && vertexColors.Num() >= parallelVertexThreshold_Local)
+		CountColorsOfEachChannel_Parallel(vertexColors.GetData(), vertexColors.Num(), byteThreshold_Local, byteCounts_Local);
+	else
+		CountColorsOfEachChannel(vertexColors.GetData(), vertexColors.Num(), byteThreshold_Local, byteCounts_Local);
+
+
+	// amountOfVerticesConsidered gets set for every channel as well since the async task uses it to check if the channel was considered at all, since with paint/detect task you have option to only include those that has a physics surface registered to them
+	FVertexDetectAmountOfPaintedColorsOfEachChannel amountOfPaintedColorsOfEachChannel_Local = GetAmountOfPaintedColorsOfEachChannelFromByteCounts(byteCounts_Local, vertexColors.Num());
+
+	// After gotten amount of vertices painted at each color etc., we can use it to set the amounts. This is used by the async task as well
+	amountOfPaintedColorsOfEachChannel_Local = ConsolidateColorsOfEachChannel(amountOfPaintedColorsOfEachChannel_Local, vertexColors.Num());
+
+
+	return amountOfPaintedColorsOfEachChannel_Local;
+}
+
+
+//--------------------------------------------------------
+
+// Get Color Channels Histogram
+
+FVertexColorChannelsHistogram VertexPaintFunctions::GetColorChannelsHistogram(const TArray<FColor>& vertexColors) {
+
+	const int32 parallelVertexThreshold_Local = CVarVertexPaintColorsOfEachChannelParallelVertexThreshold.GetValueOnAnyThread();
+
+	return FVertexColorChannelsHistogram::Build(vertexColors, parallelVertexThreshold_Local > 0 && vertexColors.Num() >= parallelVertexThreshold_Local);
+}
+
+
+//--------------------------------------------------------
+
+// Get Amount Of Painted Colors For Each Channel From Histogram
+
+FVertexDetectAmountOfPaintedColorsOfEachChannel VertexPaintFunctions::GetAmountOfPaintedColorsForEachChannelFromHistogram(const FVertexColorChannelsHistogram& colorChannelsHistogram, float minColorAmountToBeConsidered) {
+
+	if (colorChannelsHistogram.GetAmountOfVertices() <= 0) return FVertexDetectAmountOfPaintedColorsOfEachChannel();
+
+
+	// Uses the same byte threshold as GetAmountOfPaintedColorsForEachChannel so the result is identical to running that on the colors the histogram was built from, but it's only 256 steps per channel no matter how many vertices there are
+	const uint32 byteThreshold_Local = GetColorsOfEachChannelByteThreshold(minColorAmountToBeConsidered);
+
+	FColorsOfEachChannelByteCounts byteCounts_Local;
+
+	for (int32 channelIndex = 0; channelIndex < 4; channelIndex++) {
+
+		byteCounts_Local.amountOfVerticesPaintedAtMinAmount[channelIndex] = colorChannelsHistogram.GetAmountOfVerticesAtMinByte(channelIndex, byteThreshold_Local);
+		byteCounts_Local.colorAmountSumAtMinAmount[channelIndex] = colorChannelsHistogram.GetByteSumAtMinByte(channelIndex, byteThreshold_Local);
+	}
+
+	FVertexDetectAmountOfPaintedColorsOfEachChannel amountOfPaintedColorsOfEachChannel_Local = GetAmountOfPaintedColorsOfEachChannelFromByteCounts(byteCounts_Local, colorChannelsHistogram.GetAmountOfVertices());
+
+	return ConsolidateColorsOfEachChannel(amountOfPaintedColorsOfEachChannel_Local, colorChannelsHistogram.GetAmountOfVertices());
+}
+
+
+//--------------------------------------------------------
+
+// Get Amount Of Painted Colors For Each Channel On Component
+
+FVertexDetectAmountOfPaintedColorsOfEachChannel VertexPaintFunctions::GetAmountOfPaintedColorsForEachChannelOnComponent(UPrimitiveComponent* meshComponent, int lod, float minColorAmountToBeConsidered) {
+
+	if (!IsValid(meshComponent)) return FVertexDetectAmountOfPaintedColorsOfEachChannel();
+	if (lod < 0) return FVertexDetectAmountOfPaintedColorsOfEachChannel();
+
+
+	FVertexColorChannelsHistogram colorChannelsHistogram_Local;
+
+	// The first time a component and LOD gets queried we have to loop through its colors, but after that the paint and set tasks rebuilds the stats from the colors they return in their callback, so this is only 256 steps per channel no matter how big the mesh is. Useful for things like HUD widgets that polls every frame. 
+	if (!FVertexColorChannelsStatsCache::Get().GetColorChannelsHistogram(meshComponent, lod, colorChannelsHistogram_Local)) {
+
+		const FVertexColorsReadView vertexColorsReadView_Local = GetMeshComponentVertexColorsReadViewAtLOD(meshComponent, lod);
+
+		if (vertexColorsReadView_Local.Num() <= 0) return FVertexDetectAmountOfPaintedColorsOfEachChannel();
+
+		const int32 parallelVertexThreshold_Local = CVarVertexPaintColorsOfEachChannelParallelVertexThreshold.GetValueOnAnyThread();
+
+		// Unpainted meshes are all one color so their histogram is just the one entry per channel
+		if (vertexColorsReadView_Local.IsUniform())
+			colorChannelsHistogram_Local.AddUniformColor(vertexColorsReadView_Local.GetUniformColor(), vertexColorsReadView_Local.Num());
+		else
+			colorChannelsHistogram_Local = FVertexColorChannelsHistogram::Build(vertexColorsReadView_Local.GetColors(), parallelVertexThreshold_Local > 0 && vertexColorsReadView_Local.Num() >= parallelVertexThreshold_Local);
+
+		FVertexColorChannelsStatsCache::Get().SetColorChannelsHistogram(meshComponent, lod, colorChannelsHistogram_Local);
+	}
+
+	return GetAmountOfPaintedColorsForEachChannelFromHistogram(colorChannelsHistogram_Local, minColorAmountToBeConsidered);
+}
+
+
+//--------------------------------------------------------
+
+// Set Mesh Component Channel Planes Enabled
+
+void VertexPaintFunctions::SetMeshComponentChannelPlanesEnabled(UPrimitiveComponent* meshComponent, bool enabled) {
+
+	FVertexColorChannelPlanesCache::Get().SetChannelPlanesEnabled(meshComponent, enabled);
+}
+
+
+//--------------------------------------------------------
+
+// Get Amount Of Painted Colors For Channel On Component
+
+FVertexDetectAmountOfPaintedColorsOfEachChannel_Results VertexPaintFunctions::GetAmountOfPaintedColorsForChannelOnComponent(UPrimitiveComponent* meshComponent, int lod, Enum_SurfaceAtChannel surfaceAtChannel, float minColorAmountToBeConsidered) {
+
+	if (!IsValid(meshComponent)) return FVertexDetectAmountOfPaintedColorsOfEachChannel_Results();
+	if (lod < 0) return FVertexDetectAmountOfPaintedColorsOfEachChannel_Results();
+
+
+	int32 channelIndex_Local = -1;
+
+	switch (surfaceAtChannel) {
+
+	case Enum_SurfaceAtChannel::RedChannel:
+		channelIndex_Local = FVertexColorChannelsHistogram::RedChannelIndex;
+		break;
+
+	case Enum_SurfaceAtChannel::GreenChannel:
+		channelIndex_Local = FVertexColorChannelsHistogram::GreenChannelIndex;
+		break;
+
+	case Enum_SurfaceAtChannel::BlueChannel:
+		channelIndex_Local = FVertexColorChannelsHistogram::BlueChannelIndex;
+		break;
+
+	case Enum_SurfaceAtChannel::AlphaChannel:
+		channelIndex_Local = FVertexColorChannelsHistogram::AlphaChannelIndex;
+		break;
+
+	default:
+		break;
+	}
+
+	// Default isn't a channel so there's nothing to count
+	if (channelIndex_Local < 0) return FVertexDetectAmountOfPaintedColorsOfEachChannel_Results();
+
+
+	FVertexDetectAmountOfPaintedColorsOfEachChannel amountOfPaintedColorsOfEachChannel_Local;
+	FVertexColorChannelsHistogram colorChannelsHistogram_Local;
+
+	// If the stats are cached at the current colors they're only 256 steps per channel no matter how big the mesh is, so that beats streaming the channel
+	if (FVertexColorChannelsStatsCache::Get().GetColorChannelsHistogram(meshComponent, lod, colorChannelsHistogram_Local)) {
+
+		amountOfPaintedColorsOfEachChannel_Local = GetAmountOfPaintedColorsForEachChannelFromHistogram(colorChannelsHistogram_Local, minColorAmountToBeConsidered);
+	}
+
+	// If the component has opted in to Channel Planes we only have to stream the one byte of the channel per vertex, otherwise it's the same as building the stats for every channel and picking out the one we want
+	else if (const FVertexColorChannelPlanesPtr channelPlanes_Local = FVertexColorChannelPlanesCache::Get().GetChannelPlanes(meshComponent, lod)) {
+
+		const int32 parallelVertexThreshold_Local = CVarVertexPaintColorsOfEachChannelParallelVertexThreshold.GetValueOnAnyThread();
+
+		FColorsOfEachChannelByteCounts byteCounts_Local;
+		channelPlanes_Local->CountChannelAtMinByte(channelIndex_Local, GetColorsOfEachChannelByteThreshold(minColorAmountToBeConsidered), byteCounts_Local.amountOfVerticesPaintedAtMinAmount[channelIndex_Local], byteCounts_Local.colorAmountSumAtMinAmount[channelIndex_Local], parallelVertexThreshold_Local > 0 && channelPlanes_Local->GetAmountOfVertices() >= parallelVertexThreshold_Local);
+
+		amountOfPaintedColorsOfEachChannel_Local = GetAmountOfPaintedColorsOfEachChannelFromByteCounts(byteCounts_Local, channelPlanes_Local->GetAmountOfVertices());
+		amountOfPaintedColorsOfEachChannel_Local = ConsolidateColorsOfEachChannel(amountOfPaintedColorsOfEachChannel_Local, channelPlanes_Local->GetAmountOfVertices());
+	}
+
+	else {
+
+		amountOfPaintedColorsOfEachChannel_Local = GetAmountOfPaintedColorsForEachChannelOnComponent(meshComponent, lod, minColorAmountToBeConsidered);
+	}
+
+
+	switch (channelIndex_Local) {
+
+	case FVertexColorChannelsHistogram::RedChannelIndex:
+		return amountOfPaintedColorsOfEachChannel_Local.redChannelResult;
+
+	case FVertexColorChannelsHistogram::GreenChannelIndex:
+		return amountOfPaintedColorsOfEachChannel_Local.greenChannelResult;
+
+	case FVertexColorChannelsHistogram::BlueChannelIndex:
+		return amountOfPaintedColorsOfEachChannel_Local.blueChannelResult;
+
+	default:
+		return amountOfPaintedColorsOfEachChannel_Local.alphaChannelResult;
+	}
+}
+
+
+//--------------------------------------------------------
+
+// Get Mesh Component Vertex Colors Generation
+
+int64 VertexPaintFunctions::GetMeshComponentVertexColorsGeneration(UPrimitiveComponent* meshComponent, int lod) {
+
+	// Cheap enough to check every frame, so results can be cached and reused for as long as this is the same. Dynamic Meshes can be edited without us knowing, so they're watched from now on. 
+#if ENGINE_MAJOR_VERSION == 5
+	FVertexColorsGenerations::Get().WatchDynamicMeshComponent(Cast<UDynamicMeshComponent>(meshComponent));
+#endif
+
+	return static_cast<int64>(FVertexColorsGenerations::Get().GetGeneration(meshComponent, lod));
+}
+
+
+//--------------------------------------------------------
+
+// Get Amount Of Painted Colors For Each Channel Per Section
+
+// Every vertex the triangles of a section uses, once each. Sections can share vertices, and their Min and Max Vertex Index can span vertices of other sections, so the index buffer is the only thing that says which vertices are actually in a section. sectionOfVertex is shared between the sections so we don't have to clear anything between them. 
+template<typename GetIndexFunction>
+static void GetSectionVertexIndices(int32 sectionIndex, uint32 firstIndex, uint32 amountOfIndices, TArray<int32>& sectionOfVertex, const GetIndexFunction& getIndex, TArray<int32>& sectionVertexIndices) {
+
+	sectionVertexIndices.Reset();
+
+	for (uint32 i = firstIndex; i < firstIndex + amountOfIndices; i++) {
+
+		const uint32 vertexIndex_Local = getIndex(i);
+
+		if (vertexIndex_Local >= static_cast<uint32>(sectionOfVertex.Num())) continue;
+		if (sectionOfVertex[vertexIndex_Local] == sectionIndex) continue;
+
+		sectionOfVertex[vertexIndex_Local] = sectionIndex;
+		sectionVertexIndices.Add(static_cast<int32>(vertexIndex_Local));
+	}
+}
+
+
+// For a physics surface that is registered on several channels of the same material. A vertex only counts once for it if any of those channels passes the min amount, with the highest of them as its color amount, so the surface can never be more than 100% painted like it would if we added the channel results together. 
+static void CountColorsOfPhysicsSurfaceChannels(const FColor* vertexColors, int32 amountOfVertexColors, const bool (&isPhysicsSurfaceAtChannel)[4], uint32 byteThreshold, int64& amountOfVerticesPaintedAtMinAmount, int64& colorAmountSumAtMinAmount) {
+
+	if (byteThreshold > 255) return;
+
+	for (int32 i = 0; i < amountOfVertexColors; i++) {
+
+		const uint32 channelBytes_Local[4] = { vertexColors[i].R, vertexColors[i].G, vertexColors[i].B, vertexColors[i].A };
+		uint32 highestPassedByte_Local = 0;
+		bool passed_Local = false;
+
+		for (int channelIndex = 0; channelIndex < 4; channelIndex++) {
+
+			if (!isPhysicsSurfaceAtChannel[channelIndex] || channelBytes_Local[channelIndex] < byteThreshold) continue;
+
+			passed_Local = true;
+			highestPassedByte_Local = FMath::Max(highestPassedByte_Local, channelBytes_Local[channelIndex]);
+		}
+
+		amountOfVerticesPaintedAtMinAmount += passed_Local;
+		colorAmountSumAtMinAmount += highestPassedByte_Local;
+	}
+}
+
+
+TArray<FVertexDetectAmountOfPaintedColorsOfEachChannel> VertexPaintFunctions::GetAmountOfPaintedColorsForEachChannelPerSection(UPrimitiveComponent* meshComponent, int lod, float minColorAmountToBeConsidered, TArray<UMaterialInterface*>& sectionMaterials) {
+
+	sectionMaterials.Empty();
+
+	if (!IsValid(meshComponent)) return TArray<FVertexDetectAmountOfPaintedColorsOfEachChannel>();
+	if (lod < 0) return TArray<FVertexDetectAmountOfPaintedColorsOfEachChannel>();
+
+
+	const FVertexColorsReadView vertexColors_Local = GetMeshComponentVertexColorsReadViewAtLOD(meshComponent, lod);
+
+	if (vertexColors_Local.Num() <= 0) return TArray<FVertexDetectAmountOfPaintedColorsOfEachChannel>();
+
+
+	// The vertices and material index of each render section at the LOD. If the index buffer isn't available on the CPU we fall back to the sections vertex range, which can include vertices of other sections. Meshes without sections like dynamic meshes and geometry collections counts as one section with all of the vertices. 
+	struct FSectionVertices {
+
+		int32 materialIndex = 0;
+		bool useVertexIndices = false;
+		TArray<int32> vertexIndices;
+		int32 firstVertexIndex = 0;
+		int32 amountOfVertices = 0;
+	};
+
+	TArray<FSectionVertices, TInlineAllocator<8>> sectionsVertices_Local;
+	TArray<int32> sectionOfVertex_Local;
+
+
+	if (auto staticMeshComponent = Cast<UStaticMeshComponent>(meshComponent)) {
+
+		if (staticMeshComponent->GetStaticMesh() && staticMeshComponent->GetStaticMesh()->GetRenderData() && staticMeshComponent->GetStaticMesh()->GetRenderData()->LODResources.IsValidIndex(lod)) {
+
+			const FStaticMeshLODResources& lodResources_Local = staticMeshComponent->GetStaticMesh()->GetRenderData()->LODResources[lod];
+			const FIndexArrayView indexArrayView_Local = lodResources_Local.IndexBuffer.GetArrayView();
+
+			for (const FStaticMeshSection& staticMeshSectionTemp : lodResources_Local.Sections) {
+
+				if (staticMeshSectionTemp.NumTriangles <= 0) continue;
+
+				FSectionVertices& sectionVertices_Local = sectionsVertices_Local.AddDefaulted_GetRef();
+				sectionVertices_Local.materialIndex = staticMeshSectionTemp.MaterialIndex;
+
+				if (indexArrayView_Local.Num() > 0 && staticMeshSectionTemp.FirstIndex + staticMeshSectionTemp.NumTriangles * 3 <= static_cast<uint32>(indexArrayView_Local.Num())) {
+
+					if (sectionOfVertex_Local.Num() <= 0)
+						sectionOfVertex_Local.Init(INDEX_NONE, vertexColors_Local.Num());
+
+					sectionVertices_Local.useVertexIndices = true;
+					GetSectionVertexIndices(sectionsVertices_Local.Num() - 1, staticMeshSectionTemp.FirstIndex, staticMeshSectionTemp.NumTriangles * 3, sectionOfVertex_Local, [&indexArrayView_Local](uint32 index) { return static_cast<uint32>(indexArrayView_Local[index]); }, sectionVertices_Local.vertexIndices);
+				}
+
+				else {
+
+					sectionVertices_Local.firstVertexIndex = static_cast<int32>(staticMeshSectionTemp.MinVertexIndex);
+					sectionVertices_Local.amountOfVertices = static_cast<int32>(staticMeshSectionTemp.MaxVertexIndex - staticMeshSectionTemp.MinVertexIndex + 1);
+				}
+			}
+		}
+	}
+
+	else if (auto skeletalMeshComponent = Cast<USkeletalMeshComponent>(meshComponent)) {
+
+		if (skeletalMeshComponent->GetSkeletalMeshRenderData() && skeletalMeshComponent->GetSkeletalMeshRenderData()->LODRenderData.IsValidIndex(lod)) {
+
+			const FSkeletalMeshLODRenderData& lodRenderData_Local = skeletalMeshComponent->GetSkeletalMeshRenderData()->LODRenderData[lod];
+			const FRawStaticIndexBuffer16or32Interface* indexBuffer_Local = lodRenderData_Local.MultiSizeIndexContainer.IsIndexBufferValid() ? lodRenderData_Local.MultiSizeIndexContainer.GetIndexBuffer() : nullptr;
+
+			// Sections can be remapped to other materials per LOD, the same way the skeletal mesh proxy picks the material to render each section with
+			USkeletalMesh* skeletalMesh_Local = VertexPaintFunctionsLib_GetSkeletalMesh(skeletalMeshComponent);
+			const FSkeletalMeshLODInfo* lodInfo_Local = skeletalMesh_Local ? skeletalMesh_Local->GetLODInfo(lod) : nullptr;
+
+			for (int32 sectionIndex = 0; sectionIndex < lodRenderData_Local.RenderSections.Num(); sectionIndex++) {
+
+				const FSkelMeshRenderSection& skelMeshSection_Local = lodRenderData_Local.RenderSections[sectionIndex];
+
+				if (skelMeshSection_Local.NumVertices <= 0) continue;
+
+				FSectionVertices& sectionVertices_Local = sectionsVertices_Local.AddDefaulted_GetRef();
+				sectionVertices_Local.materialIndex = skelMeshSection_Local.MaterialIndex;
+
+				if (lodInfo_Local && lodInfo_Local->LODMaterialMap.IsValidIndex(sectionIndex) && lodInfo_Local->LODMaterialMap[sectionIndex] != INDEX_NONE)
+					sectionVertices_Local.materialIndex = lodInfo_Local->LODMaterialMap[sectionIndex];
+
+				if (indexBuffer_Local && indexBuffer_Local->Num() > 0 && skelMeshSection_Local.BaseIndex + skelMeshSection_Local.NumTriangles * 3 <= static_cast<uint32>(indexBuffer_Local->Num())) {
+
+					if (sectionOfVertex_Local.Num() <= 0)
+						sectionOfVertex_Local.Init(INDEX_NONE, vertexColors_Local.Num());
+
+					sectionVertices_Local.useVertexIndices = true;
+					GetSectionVertexIndices(sectionsVertices_Local.Num() - 1, skelMeshSection_Local.BaseIndex, skelMeshSection_Local.NumTriangles * 3, sectionOfVertex_Local, [indexBuffer_Local](uint32 index) { return indexBuffer_Local->Get(index); }, sectionVertices_Local.vertexIndices);
+				}
+
+				else {
+
+					sectionVertices_Local.firstVertexIndex = static_cast<int32>(skelMeshSection_Local.BaseVertexIndex);
+					sectionVertices_Local.amountOfVertices = static_cast<int32>(skelMeshSection_Local.NumVertices);
+				}
+			}
+		}
+	}
+
+	if (sectionsVertices_Local.Num() <= 0) {
+
+		FSectionVertices& sectionVertices_Local = sectionsVertices_Local.AddDefaulted_GetRef();
+		sectionVertices_Local.amountOfVertices = vertexColors_Local.Num();
+	}
+
+
+	const uint32 byteThreshold_Local = GetColorsOfEachChannelByteThreshold(minColorAmountToBeConsidered);
+	UVertexPaintMaterialDataAsset* materialDataAsset_Local = GetVertexPaintMaterialDataAsset(meshComponent);
+
+	TArray<FVertexDetectAmountOfPaintedColorsOfEachChannel> amountOfPaintedColorsPerSection_Local;
+	amountOfPaintedColorsPerSection_Local.Reserve(sectionsVertices_Local.Num());
+	sectionMaterials.Reserve(sectionsVertices_Local.Num());
+
+	// The colors of a section that is made up of vertex indices are gathered into this so they can be counted the same as a range. Reused by every section. 
+	TArray<FColor> gatheredSectionColors_Local;
+
+
+	// The physics surfaces are resolved from the channel counts, and only surfaces registered on several channels loops through the sections vertices again
+	for (const FSectionVertices& sectionVerticesTemp : sectionsVertices_Local) {
+
+		UMaterialInterface* sectionMaterial_Local = meshComponent->GetMaterial(sectionVerticesTemp.materialIndex);
+		sectionMaterials.Add(sectionMaterial_Local);
+
+
+		// Points at the sections colors, so they're contiguous whether it's a range or gathered from vertex indices. Uniform views only have the one color which every vertex has. 
+		const FColor* sectionColors_Local = nullptr;
+		int32 amountOfVertices_Local = 0;
+
+		if (sectionVerticesTemp.useVertexIndices) {
+
+			amountOfVertices_Local = sectionVerticesTemp.vertexIndices.Num();
+
+			if (!vertexColors_Local.IsUniform() && amountOfVertices_Local > 0) {
+
+				const FColor* vertexColorsData_Local = vertexColors_Local.GetData();
+
+				// Reset keeps the allocation from the previous section
+				gatheredSectionColors_Local.Reset();
+				gatheredSectionColors_Local.SetNumUninitialized(amountOfVertices_Local);
+
+				for (int32 i = 0; i < amountOfVertices_Local; i++)
+					gatheredSectionColors_Local[i] = vertexColorsData_Local[sectionVerticesTemp.vertexIndices[i]];
+
+				sectionColors_Local = gatheredSectionColors_Local.GetData();
+			}
+		}
+
+		else {
+
+			const int32 firstVertexIndex_Local = FMath::Clamp(sectionVerticesTemp.firstVertexIndex, 0, vertexColors_Local.Num());
+			amountOfVertices_Local = FMath::Clamp(sectionVerticesTemp.amountOfVertices, 0, vertexColors_Local.Num() - firstVertexIndex_Local);
+
+			if (!vertexColors_Local.IsUniform())
+				sectionColors_Local = vertexColors_Local.GetData() + firstVertexIndex_Local;
+		}
+
+		if (amountOfVertices_Local <= 0) {
+
+			amountOfPaintedColorsPerSection_Local.Add(FVertexDetectAmountOfPaintedColorsOfEachChannel());
+			continue;
+		}
+
+
+		FColorsOfEachChannelByteCounts byteCounts_Local;
+
+		if (vertexColors_Local.IsUniform())
+			CountUniformColorOfEachChannel(vertexColors_Local.GetUniformColor(), amountOfVertices_Local, byteThreshold_Local, byteCounts_Local);
+		else
+			CountColorsOfEachChannel(sectionColors_Local, amountOfVertices_Local, byteThreshold_Local, byteCounts_Local);
+
+		FVertexDetectAmountOfPaintedColorsOfEachChannel sectionResult_Local = GetAmountOfPaintedColorsOfEachChannelFromByteCounts(byteCounts_Local, amountOfVertices_Local);
+
+
+		// Each physics surface registered at a channel on the sections material gets the result of that channel. If the same surface is on several channels its vertices are counted again over those channels together, so a vertex painted on more than one of them only counts once. 
+		if (materialDataAsset_Local && IsValid(sectionMaterial_Local)) {
+
+			UMaterialInterface* registeredMaterial_Local = materialDataAsset_Local->GetRegisteredMaterialInstanceOrParentMaterial(sectionMaterial_Local);
+
+			if (IsValid(registeredMaterial_Local) && materialDataAsset_Local->GetVertexPaintMaterialInterface().Contains(registeredMaterial_Local)) {
+
+				const FVertexPaintMaterialDataAssetStruct& materialDataAssetStruct_Local = materialDataAsset_Local->GetVertexPaintMaterialInterface().FindChecked(registeredMaterial_Local);
+
+				const TEnumAsByte<EPhysicalSurface> physicsSurfaceAtChannels_Local[4] = { materialDataAssetStruct_Local.paintedAtRed, materialDataAssetStruct_Local.paintedAtGreen, materialDataAssetStruct_Local.paintedAtBlue, materialDataAssetStruct_Local.paintedAtAlpha };
+				const FVertexDetectAmountOfPaintedColorsOfEachChannel_Results* channelResults_Local[4] = { &sectionResult_Local.redChannelResult, &sectionResult_Local.greenChannelResult, &sectionResult_Local.blueChannelResult, &sectionResult_Local.alphaChannelResult };
+
+				for (int channelIndex = 0; channelIndex < 4; channelIndex++) {
+
+					if (physicsSurfaceAtChannels_Local[channelIndex] == EPhysicalSurface::SurfaceType_Default) continue;
+					if (sectionResult_Local.physicsSurfacesResult.Contains(physicsSurfaceAtChannels_Local[channelIndex])) continue;
+
+
+					bool isPhysicsSurfaceAtChannel_Local[4] = { false, false, false, false };
+					int amountOfChannelsWithPhysicsSurface_Local = 0;
+
+					for (int otherChannelIndex = channelIndex; otherChannelIndex < 4; otherChannelIndex++) {
+
+						if (physicsSurfaceAtChannels_Local[otherChannelIndex] != physicsSurfaceAtChannels_Local[channelIndex]) continue;
+
+						isPhysicsSurfaceAtChannel_Local[otherChannelIndex] = true;
+						amountOfChannelsWithPhysicsSurface_Local++;
+					}
+
+					FVertexDetectAmountOfPaintedColorsOfEachChannel_Results& physicsSurfaceResult_Local = sectionResult_Local.physicsSurfacesResult.Add(physicsSurfaceAtChannels_Local[channelIndex]);
+
+					if (amountOfChannelsWithPhysicsSurface_Local == 1) {
+
+						physicsSurfaceResult_Local = *channelResults_Local[channelIndex];
+						continue;
+					}
+
+
+					int64 amountOfVerticesPaintedAtMinAmount_Local = 0;
+					int64 colorAmountSumAtMinAmount_Local = 0;
+
+					if (vertexColors_Local.IsUniform()) {
+
+						const FColor uniformColor_Local = vertexColors_Local.GetUniformColor();
+						CountColorsOfPhysicsSurfaceChannels(&uniformColor_Local, 1, isPhysicsSurfaceAtChannel_Local, byteThreshold_Local, amountOfVerticesPaintedAtMinAmount_Local, colorAmountSumAtMinAmount_Local);
+
+						amountOfVerticesPaintedAtMinAmount_Local *= amountOfVertices_Local;
+						colorAmountSumAtMinAmount_Local *= amountOfVertices_Local;
+					}
+
+					else {
+
+						CountColorsOfPhysicsSurfaceChannels(sectionColors_Local, amountOfVertices_Local, isPhysicsSurfaceAtChannel_Local, byteThreshold_Local, amountOfVerticesPaintedAtMinAmount_Local, colorAmountSumAtMinAmount_Local);
+					}
+
+					physicsSurfaceResult_Local.amountOfVerticesConsidered = amountOfVertices_Local;
+					physicsSurfaceResult_Local.amountOfVerticesPaintedAtMinAmount = amountOfVerticesPaintedAtMinAmount_Local;
+					physicsSurfaceResult_Local.averageColorAmountAtMinAmount = static_cast<float>(static_cast<double>(colorAmountSumAtMinAmount_Local) / 255.0);
+				}
+			}
+		}
+
+
+		sectionResult_Local = ConsolidateColorsOfEachChannel(sectionResult_Local, amountOfVertices_Local);
+		sectionResult_Local = ConsolidatePhysicsSurfaceResult(sectionResult_Local, amountOfVertices_Local);
+
+		amountOfPaintedColorsPerSection_Local.Add(sectionResult_Local);
+	}
+
+	return amountOfPaintedColorsPerSection_Local;
+}
+
+
+//--------------------------------------------------------
+
+// Get Amount Of Painted Colors For Each Channel Within Shape
 
-bool VertexPaintFunctions::isGetAmountOfPaintedColorsForEachChannelAsyncTaskRunning = false;
+FVertexDetectAmountOfPaintedColorsOfEachChannel VertexPaintFunctions::GetAmountOfPaintedColorsForEachChannelWithinShape(UPrimitiveComponent* meshComponent, int lod, const FCollisionShape& shape, const FVector& shapeLocation, const FQuat& shapeRotation, float minColorAmountToBeConsidered) {
 
-void VertexPaintFunctions::GetAmountOfPaintedColorsForEachChannelAsync(UObject* WorldContextObject, FLatentActionInfo LatentInfo, const TArray<FColor>& vertexColors, float minColorAmountToBeConsidered, FVertexDetectAmountOfPaintedColorsOfEachChannel& amountOfColorsOfEachChannel) {
+	if (!IsValid(meshComponent)) return FVertexDetectAmountOfPaintedColorsOfEachChannel();
+	if (lod < 0) return FVertexDetectAmountOfPaintedColorsOfEachChannel();
+	if (shape.IsLine()) return FVertexDetectAmountOfPaintedColorsOfEachChannel();
 
-	if (isGetAmountOfPaintedColorsForEachChannelAsyncTaskRunning) {
 
-		UE_LOG(LogTemp, Log, TEXT("Trying to Start GetAmountOfPaintedColorsForEachChannelAsync but it already has a Task awaiting to be Finished!"));
-		return;
-	}
+	// The index is built from the source mesh positions, so it only works with meshes that aren't deformed when rendered. Spline meshes get bent along the spline, and skeletal meshes are skinned, so their positions in the source mesh doesn't match where they actually are. 
+	UStaticMeshComponent* staticMeshComponent_Local = Cast<UStaticMeshComponent>(meshComponent);
 
+	if (!staticMeshComponent_Local || Cast<USplineMeshComponent>(meshComponent)) return FVertexDetectAmountOfPaintedColorsOfEachChannel();
 
-	if (UWorld* World = WorldContextObject->GetWorld()) {
 
-		// Instantiate the AsyncTask
-		FColorsOfEachChannelAsyncTask* calculateColorsOfEachChannelAsyncTask = new FColorsOfEachChannelAsyncTask(vertexColors, minColorAmountToBeConsidered);
+	TSharedPtr<const FVertexPositionSpatialIndex, ESPMode::ThreadSafe> spatialIndex_Local = FVertexPositionSpatialIndex::GetOrBuild(staticMeshComponent_Local->GetStaticMesh(), lod);
 
-		// Create our custom latent action and add to manager
-		FColorsOfEachChannelLatentAction* LatentAction = new FColorsOfEachChannelLatentAction(LatentInfo, calculateColorsOfEachChannelAsyncTask);
-		World->GetLatentActionManager().AddNewAction(LatentInfo.CallbackTarget, LatentInfo.UUID, LatentAction);
+	if (!spatialIndex_Local.IsValid()) return FVertexDetectAmountOfPaintedColorsOfEachChannel();
 
-		// Bind the delegate and sets the result
-		calculateColorsOfEachChannelAsyncTask->OnTaskComplete.BindLambda([&amountOfColorsOfEachChannel, LatentAction](const FVertexDetectAmountOfPaintedColorsOfEachChannel& amountOfPaintedColorsOfEachChannelResult) {
 
-			amountOfColorsOfEachChannel = amountOfPaintedColorsOfEachChannelResult;
-			isGetAmountOfPaintedColorsForEachChannelAsyncTaskRunning = false;
+	const FVertexColorsReadView vertexColors_Local = GetMeshComponentVertexColorsReadViewAtLOD(meshComponent, lod);
 
-			LatentAction->MarkAsCompleted();
-		});
+	if (vertexColors_Local.Num() != spatialIndex_Local->GetAmountOfVertices()) return FVertexDetectAmountOfPaintedColorsOfEachChannel();
 
-		isGetAmountOfPaintedColorsForEachChannelAsyncTaskRunning = true;
 
-		(new FAutoDeleteAsyncTask<FColorsOfEachChannelAsyncTask>(*calculateColorsOfEachChannelAsyncTask))->StartBackgroundTask();
-	}
-}
+	// The shape's bounds in the components local space, which is what we get the candidate cells from. Since the component can have non-uniform scale the shape itself isn't converted, instead each candidate is converted to world space and checked against the shape there. 
+	const FTransform componentTransform_Local = meshComponent->GetComponentTransform();
+	const FVector shapeExtent_Local = shape.GetExtent();
+	const FBox shapeLocalBounds_Local = FBox(-shapeExtent_Local, shapeExtent_Local).TransformBy(FTransform(shapeRotation, shapeLocation)).InverseTransformBy(componentTransform_Local);
 
+	TArray<int32> candidateVertexIndices_Local;
+	spatialIndex_Local->GetVerticesInCellsOverlappingBox(shapeLocalBounds_Local, candidateVertexIndices_Local);
 
-//--------------------------------------------------------
 
-// Get Amount Of Painted Colors For Each Channel
+	TArray<FColor> vertexColorsWithinShape_Local;
+	vertexColorsWithinShape_Local.Reserve(candidateVertexIndices_Local.Num());
 
-FVertexDetectAmountOfPaintedColorsOfEachChannel VertexPaintFunctions::GetAmountOfPaintedColorsForEachChannel(const TArray<FColor>& vertexColors, float minColorAmountToBeConsidered) {
+	for (int32 candidateVertexIndexTemp : candidateVertexIndices_Local) {
 
-	if (vertexColors.Num() <= 0) return FVertexDetectAmountOfPaintedColorsOfEachChannel();
+		const FVector vertexWorldPosition_Local = componentTransform_Local.TransformPosition(FVector(spatialIndex_Local->GetLocalVertexPosition(candidateVertexIndexTemp)));
+		const FVector vertexPositionInShape_Local = shapeRotation.UnrotateVector(vertexWorldPosition_Local - shapeLocation);
 
+		bool isWithinShape_Local = false;
 
-	FVertexDetectAmountOfPaintedColorsOfEachChannel amountOfPaintedColorsOfEachChannel_Local;
-	FLinearColor linearColor_Local;
+		if (shape.IsSphere()) {
+
+			isWithinShape_Local = vertexPositionInShape_Local.SizeSquared() <= FMath::Square(shape.GetSphereRadius());
+		}
 
+		else if (shape.IsBox()) {
 
-	for (auto colorTemp : vertexColors) {
+			const FVector boxHalfExtent_Local = shape.GetBox();
+			isWithinShape_Local = FMath::Abs(vertexPositionInShape_Local.X) <= boxHalfExtent_Local.X && FMath::Abs(vertexPositionInShape_Local.Y) <= boxHalfExtent_Local.Y && FMath::Abs(vertexPositionInShape_Local.Z) <= boxHalfExtent_Local.Z;
+		}
 
-		linearColor_Local = colorTemp.ReinterpretAsLinear(); // So we only have to run Reinterpret once
+		else if (shape.IsCapsule()) {
 
+			// Capsule half height includes the radius, same as capsule components, so the segment between the two sphere centers is half height minus radius in each direction along Z
+			const float capsuleRadius_Local = shape.GetCapsuleRadius();
+			const float capsuleSegmentHalfLength_Local = FMath::Max(0.f, shape.GetCapsuleHalfHeight() - capsuleRadius_Local);
+			const FVector closestPointOnSegment_Local = FVector(0, 0, FMath::Clamp(vertexPositionInShape_Local.Z, -capsuleSegmentHalfLength_Local, capsuleSegmentHalfLength_Local));
 
-		// These are used by the async task to check if even the vertex channel was considered, since with paint/detect task you have option to only include those that has a physics surface registered to them, and if they're not, they won't even be considered and if none where considered we didn't run any more logic in FillAmountOfPaintedColorsOfEachChannel()
-		amountOfPaintedColorsOfEachChannel_Local.redChannelResult.amountOfVerticesConsidered++;
-		amountOfPaintedColorsOfEachChannel_Local.greenChannelResult.amountOfVerticesConsidered++;
-		amountOfPaintedColorsOfEachChannel_Local.blueChannelResult.amountOfVerticesConsidered++;
-		amountOfPaintedColorsOfEachChannel_Local.alphaChannelResult.amountOfVerticesConsidered++;
+			isWithinShape_Local = (vertexPositionInShape_Local - closestPointOnSegment_Local).SizeSquared() <= FMath::Square(capsuleRadius_Local);
+		}
 
+		if (isWithinShape_Local)
+			vertexColorsWithinShape_Local.Add(vertexColors_Local[candidateVertexIndexTemp]);
+	}
 
-		if (linearColor_Local.R >= minColorAmountToBeConsidered) {
+	if (vertexColorsWithinShape_Local.Num() <= 0) return FVertexDetectAmountOfPaintedColorsOfEachChannel();
 
-			amountOfPaintedColorsOfEachChannel_Local.redChannelResult.amountOfVerticesPaintedAtMinAmount++;
-			amountOfPaintedColorsOfEachChannel_Local.redChannelResult.averageColorAmountAtMinAmount += linearColor_Local.R;
-		}
-		if (linearColor_Local.G >= minColorAmountToBeConsidered) {
 
-			amountOfPaintedColorsOfEachChannel_Local.greenChannelResult.amountOfVerticesPaintedAtMinAmount++;
-			amountOfPaintedColorsOfEachChannel_Local.greenChannelResult.averageColorAmountAtMinAmount += linearColor_Local.G;
-		}
-		if (linearColor_Local.B >= minColorAmountToBeConsidered) {
+	FColorsOfEachChannelByteCounts byteCounts_Local;
+	CountColorsOfEachChannel(vertexColorsWithinShape_Local.GetData(), vertexColorsWithinShape_Local.Num(), GetColorsOfEachChannelByteThreshold(minColorAmountToBeConsidered), byteCounts_Local);
 
-			amountOfPaintedColorsOfEachChannel_Local.blueChannelResult.amountOfVerticesPaintedAtMinAmount++;
-			amountOfPaintedColorsOfEachChannel_Local.blueChannelResult.averageColorAmountAtMinAmount += linearColor_Local.B;
-		}
-		if (linearColor_Local.A >= minColorAmountToBeConsidered) {
+	return ConsolidateColorsOfEachChannel(GetAmountOfPaintedColorsOfEachChannelFromByteCounts(byteCounts_Local, vertexColorsWithinShape_Local.Num()), vertexColorsWithinShape_Local.Num());
+}
 
-			amountOfPaintedColorsOfEachChannel_Local.alphaChannelResult.amountOfVerticesPaintedAtMinAmount++;
-			amountOfPaintedColorsOfEachChannel_Local.alphaChannelResult.averageColorAmountAtMinAmount += linearColor_Local.A;
-		}
-	}
+FVertexDetectAmountOfPaintedColorsOfEachChannel VertexPaintFunctions::GetAmountOfPaintedColorsForEachChannelWithinSphere(UPrimitiveComponent* meshComponent, int lod, FVector sphereLocation, float sphereRadius, float minColorAmountToBeConsidered) {
 
-	// After gotten amount of vertices painted at each color etc., we can use it to set the amounts. This is used by the async task as well
-	amountOfPaintedColorsOfEachChannel_Local = ConsolidateColorsOfEachChannel(amountOfPaintedColorsOfEachChannel_Local, vertexColors.Num());
+	return GetAmountOfPaintedColorsForEachChannelWithinShape(meshComponent, lod, FCollisionShape::MakeSphere(sphereRadius), sphereLocation, FQuat::Identity, minColorAmountToBeConsidered);
+}
 
+FVertexDetectAmountOfPaintedColorsOfEachChannel VertexPaintFunctions::GetAmountOfPaintedColorsForEachChannelWithinBox(UPrimitiveComponent* meshComponent, int lod, FVector boxLocation, FRotator boxRotation, FVector boxExtent, float minColorAmountToBeConsidered) {
 
-	return amountOfPaintedColorsOfEachChannel_Local;
+	return GetAmountOfPaintedColorsForEachChannelWithinShape(meshComponent, lod, FCollisionShape::MakeBox(boxExtent), boxLocation, boxRotation.Quaternion(), minColorAmountToBeConsidered);
+}
+
+FVertexDetectAmountOfPaintedColorsOfEachChannel VertexPaintFunctions::GetAmountOfPaintedColorsForEachChannelWithinCapsule(UPrimitiveComponent* meshComponent, int lod, FVector capsuleLocation, FRotator capsuleRotation, float capsuleRadius, float capsuleHalfHeight, float minColorAmountToBeConsidered) {
+
+	return GetAmountOfPaintedColorsForEachChannelWithinShape(meshComponent, lod, FCollisionShape::MakeCapsule(capsuleRadius, capsuleHalfHeight), capsuleLocation, capsuleRotation.Quaternion(), minColorAmountToBeConsidered);
 }
 
 
@@ -1325,6 +2520,10 @@ UDynamicMesh* VertexPaintFunctions::SetMeshConstantVertexColorsAndEnablesThem(UD
 		colorToApplyTemp.A = 0;
 
 		dynamicMesh3->EnableVertexColors(FVector3f(colorToApplyTemp.R, colorToApplyTemp.G, colorToApplyTemp.B));
+
+		// Changes the colors straight on the mesh without broadcasting it, so anything cached from the previous colors of the component that has it has to be told
+		if (UDynamicMeshComponent* dynamicMeshComponent_Local = TargetMesh->GetTypedOuter<UDynamicMeshComponent>())
+			FVertexColorsGenerations::Get().BumpGenerationOfAllLODs(dynamicMeshComponent_Local);
 	}
 
 
@@ -1370,49 +2569,73 @@ FVertexDetectAmountOfPaintedColorsOfEachChannel VertexPaintFunctions::Consolidat
 
 // Consolidate Physics Surface Result
 
-FVertexDetectAmountOfPaintedColorsOfEachChannel VertexPaintFunctions::ConsolidatePhysicsSurfaceResult(FVertexDetectAmountOfPaintedColorsOfEachChannel amountOfColorsOfEachChannel, int amountOfVertices) {
-
-	if (amountOfVertices <= 0) return amountOfColorsOfEachChannel;
-	if (amountOfColorsOfEachChannel.physicsSurfacesResult.Num() <= 0) return amountOfColorsOfEachChannel;
-
+// Consolidates every physics surface that was considered and sorts them from the most painted to the least, in place in the inline array so it never allocates
+static void FillRankedPhysicsSurfaceResults(const TMap<TEnumAsByte<EPhysicalSurface>, FVertexDetectAmountOfPaintedColorsOfEachChannel_Results>& physicsSurfacesResult, int amountOfVertices, FVertexDetectRankedPhysicsSurfaceResults& rankedPhysicsSurfaceResults) {
 
-	for (auto& physicsSurfaceResultsTemp : amountOfColorsOfEachChannel.physicsSurfacesResult) {
+	rankedPhysicsSurfaceResults.physicsSurfacesByRank.Reset();
 
-		if (physicsSurfaceResultsTemp.Value.amountOfVerticesConsidered <= 0) continue;
+	for (const auto& physicsSurfaceResultsTemp : physicsSurfacesResult) {
 
-		physicsSurfaceResultsTemp.Value.averageColorAmountAtMinAmount = physicsSurfaceResultsTemp.Value.averageColorAmountAtMinAmount / amountOfVertices;
+		FVertexDetectAmountOfPaintedColorsOfEachChannel_Results physicsSurfaceResult_Local = physicsSurfaceResultsTemp.Value;
 
-		physicsSurfaceResultsTemp.Value.percentPaintedAtMinAmount = physicsSurfaceResultsTemp.Value.amountOfVerticesPaintedAtMinAmount / amountOfVertices;
-		physicsSurfaceResultsTemp.Value.percentPaintedAtMinAmount *= 100;
-	}
+		if (physicsSurfaceResult_Local.amountOfVerticesConsidered > 0) {
 
+			physicsSurfaceResult_Local.averageColorAmountAtMinAmount = physicsSurfaceResult_Local.averageColorAmountAtMinAmount / amountOfVertices;
 
-	// Create a TArray of pairs to hold the elements and their float values
-	TArray<TPair<TEnumAsByte<EPhysicalSurface>, FVertexDetectAmountOfPaintedColorsOfEachChannel_Results>> SortedArray;
-	for (const auto& Pair : amountOfColorsOfEachChannel.physicsSurfacesResult) {
+			physicsSurfaceResult_Local.percentPaintedAtMinAmount = physicsSurfaceResult_Local.amountOfVerticesPaintedAtMinAmount / amountOfVertices;
+			physicsSurfaceResult_Local.percentPaintedAtMinAmount *= 100;
+		}
 
-		SortedArray.Add(TPair<TEnumAsByte<EPhysicalSurface>, FVertexDetectAmountOfPaintedColorsOfEachChannel_Results>(Pair.Key, Pair.Value));
+		rankedPhysicsSurfaceResults.physicsSurfacesByRank.Emplace(physicsSurfaceResultsTemp.Key, physicsSurfaceResult_Local);
 	}
 
 	// Sort the array based on painted percent
-	SortedArray.Sort([](const TPair<TEnumAsByte<EPhysicalSurface>, FVertexDetectAmountOfPaintedColorsOfEachChannel_Results>& A, const TPair<TEnumAsByte<EPhysicalSurface>, FVertexDetectAmountOfPaintedColorsOfEachChannel_Results>& B) {
+	rankedPhysicsSurfaceResults.physicsSurfacesByRank.Sort([](const FVertexDetectRankedPhysicsSurfaceResults::FRankedPhysicsSurfaceResult& A, const FVertexDetectRankedPhysicsSurfaceResults::FRankedPhysicsSurfaceResult& B) {
 		return A.Value.percentPaintedAtMinAmount > B.Value.percentPaintedAtMinAmount;
 		});
+}
 
-	TMap<TEnumAsByte<EPhysicalSurface>, FVertexDetectAmountOfPaintedColorsOfEachChannel_Results> sortedPhysicsSurfacesResultTemp;
-	for (const auto& Pair : SortedArray) {
+FVertexDetectAmountOfPaintedColorsOfEachChannel VertexPaintFunctions::ConsolidatePhysicsSurfaceResult(FVertexDetectAmountOfPaintedColorsOfEachChannel amountOfColorsOfEachChannel, int amountOfVertices) {
+
+	if (amountOfVertices <= 0) return amountOfColorsOfEachChannel;
+	if (amountOfColorsOfEachChannel.physicsSurfacesResult.Num() <= 0) return amountOfColorsOfEachChannel;
+
+
+	FVertexDetectRankedPhysicsSurfaceResults rankedPhysicsSurfaceResults_Local;
+	FillRankedPhysicsSurfaceResults(amountOfColorsOfEachChannel.physicsSurfacesResult, amountOfVertices, rankedPhysicsSurfaceResults_Local);
 
-		sortedPhysicsSurfacesResultTemp.Add(Pair.Key, Pair.Value);
-	}
 
+	// Re-adds them in sorted order so the TMap iterates by rank. Reset keeps the TMaps allocation so since it's the same amount of elements it doesn't have to allocate again, unlike building a brand new TMap. 
+	amountOfColorsOfEachChannel.physicsSurfacesResult.Reset();
+
+	for (const FVertexDetectRankedPhysicsSurfaceResults::FRankedPhysicsSurfaceResult& rankedPhysicsSurfaceResultTemp : rankedPhysicsSurfaceResults_Local)
+		amountOfColorsOfEachChannel.physicsSurfacesResult.Add(rankedPhysicsSurfaceResultTemp.Key, rankedPhysicsSurfaceResultTemp.Value);
 
-	amountOfColorsOfEachChannel.physicsSurfacesResult = sortedPhysicsSurfacesResultTemp;
 	amountOfColorsOfEachChannel.successfullyGotPhysicsSurfaceResultsAtMinAmount = true;
 
 	return amountOfColorsOfEachChannel;
 }
 
 
+//--------------------------------------------------------
+
+// Consolidate Physics Surface Result Ranked
+
+bool VertexPaintFunctions::ConsolidatePhysicsSurfaceResultRanked(const FVertexDetectAmountOfPaintedColorsOfEachChannel& amountOfColorsOfEachChannel, int amountOfVertices, FVertexDetectRankedPhysicsSurfaceResults& rankedPhysicsSurfaceResults) {
+
+	rankedPhysicsSurfaceResults.physicsSurfacesByRank.Reset();
+
+	if (amountOfVertices <= 0) return false;
+	if (amountOfColorsOfEachChannel.physicsSurfacesResult.Num() <= 0) return false;
+
+
+	// Same result as ConsolidatePhysicsSurfaceResult but without copying the whole struct or touching any TMap, so consumers can just iterate it by rank
+	FillRankedPhysicsSurfaceResults(amountOfColorsOfEachChannel.physicsSurfacesResult, amountOfVertices, rankedPhysicsSurfaceResults);
+
+	return true;
+}
+
+
 //--------------------------------------------------------
 
 // Get Skeletal Mesh
@@ -1455,37 +2678,22 @@ FVertexDetectMeshDataStruct VertexPaintFunctions::GetMeshComponentVertexColors_W
 
 
 	FVertexDetectMeshDataStruct vertexMeshData_Local;
-	TArray<FVertexDetectMeshDataPerLODStruct> meshDataPerLod_Local;
 	int amountOfLODsToGet = getColorsUpToLOD + 1;
 
 
+	// Only figures out the source mesh and how many LODs there are for each type, the reading itself is the same for all of them
 	if (auto staticMeshComponent = Cast<UStaticMeshComponent>(meshComponent)) {
 
 		if (!IsValid(staticMeshComponent->GetStaticMesh())) return FVertexDetectMeshDataStruct();
+		if (!staticMeshComponent->GetStaticMesh()->GetRenderData()) return FVertexDetectMeshDataStruct();
 
 
 		vertexMeshData_Local.meshComp = staticMeshComponent;
 		vertexMeshData_Local.meshSource = staticMeshComponent->GetStaticMesh();
 
-		if (getColorsForAllLODs)
-			amountOfLODsToGet = staticMeshComponent->GetStaticMesh()->GetRenderData()->LODResources.Num();
-
-
-		for (int i = 0; i < amountOfLODsToGet; i++) {
-
-			FVertexDetectMeshDataPerLODStruct meshDataPerLodTemp;
-			meshDataPerLodTemp.lod = i;
-			meshDataPerLodTemp.meshVertexColorsPerLODArray = GetStaticMeshVertexColorsAtLOD(staticMeshComponent, i);
-
-			// If actually got any colors, i.e. the lod was valid
-			if (meshDataPerLodTemp.meshVertexColorsPerLODArray.Num() > 0)
-				meshDataPerLod_Local.Add(meshDataPerLodTemp);
-		}
-
-		vertexMeshData_Local.meshDataPerLOD = meshDataPerLod_Local;
-		success = true;
-
-		return vertexMeshData_Local;
+		// LODs above what the mesh has would've returned no colors anyway
+		const int amountOfLODsOnMesh_Local = staticMeshComponent->GetStaticMesh()->GetRenderData()->LODResources.Num();
+		amountOfLODsToGet = getColorsForAllLODs ? amountOfLODsOnMesh_Local : FMath::Min(amountOfLODsToGet, amountOfLODsOnMesh_Local);
 	}
 
 	else if (auto skeletalMeshComponent = Cast<USkeletalMeshComponent>(meshComponent)) {
@@ -1493,75 +2701,78 @@ FVertexDetectMeshDataStruct VertexPaintFunctions::GetMeshComponentVertexColors_W
 		const UObject* skelMesh = VertexPaintFunctions::GetMeshComponentSourceMesh(skeletalMeshComponent);
 
 		if (!IsValid(skelMesh)) return FVertexDetectMeshDataStruct();
+		if (!skeletalMeshComponent->GetSkeletalMeshRenderData()) return FVertexDetectMeshDataStruct();
 
 
 		vertexMeshData_Local.meshComp = skeletalMeshComponent;
 		vertexMeshData_Local.meshSource = skelMesh;
 
-		if (getColorsForAllLODs)
-			amountOfLODsToGet = skeletalMeshComponent->GetSkeletalMeshRenderData()->LODRenderData.Num();
+		const int amountOfLODsOnMesh_Local = skeletalMeshComponent->GetSkeletalMeshRenderData()->LODRenderData.Num();
+		amountOfLODsToGet = getColorsForAllLODs ? amountOfLODsOnMesh_Local : FMath::Min(amountOfLODsToGet, amountOfLODsOnMesh_Local);
+	}
+
+#if ENGINE_MAJOR_VERSION == 5
 
+	// Dynamic Meshes and Geometry Collections only have the one LOD
+	else if (auto dynamicMeshComponent = Cast<UDynamicMeshComponent>(meshComponent)) {
 
-		for (int i = 0; i < amountOfLODsToGet; i++) {
+		vertexMeshData_Local.meshComp = dynamicMeshComponent;
+		amountOfLODsToGet = 1;
+	}
 
-			FVertexDetectMeshDataPerLODStruct meshDataPerLodTemp;
-			meshDataPerLodTemp.lod = i;
-			meshDataPerLodTemp.meshVertexColorsPerLODArray = GetSkeletalMeshVertexColorsAtLOD(skeletalMeshComponent, i);
+	else if (auto geometryCollectionComponent = Cast<UGeometryCollectionComponent>(meshComponent)) {
 
-			// If actually got any colors, i.e. the lod was valid
-			if (meshDataPerLodTemp.meshVertexColorsPerLODArray.Num() > 0)
-				meshDataPerLod_Local.Add(meshDataPerLodTemp);
-		}
+		vertexMeshData_Local.meshComp = geometryCollectionComponent;
+		vertexMeshData_Local.meshSource = geometryCollectionComponent->GetRestCollection();
+		amountOfLODsToGet = 1;
+	}
 
-		vertexMeshData_Local.meshDataPerLOD = meshDataPerLod_Local;
-		success = true;
+#endif
+
+	else {
 
-		return vertexMeshData_Local;
+		return FVertexDetectMeshDataStruct();
 	}
 
-#if ENGINE_MAJOR_VERSION == 5
 
-	else if (auto dynamicMeshComponent = Cast<UDynamicMeshComponent>(meshComponent)) {
+	TArray<FVertexDetectMeshDataPerLODStruct> meshDataPerLod_Local;
+	meshDataPerLod_Local.SetNum(FMath::Max(0, amountOfLODsToGet));
 
-		vertexMeshData_Local.meshComp = dynamicMeshComponent;
-		// vertexMeshData_Local.meshSource = ;
+	// Queues the restore if the component is in a snapshot that hasn't been applied to it yet, here on the Game Thread since the LOD tasks below may not be on it. The task that Sets the colors hasn't run yet so LOD0 gets the snapshot colors directly. The snapshot only has LOD0, which the task propagates to the other LODs, so until it has run they still have the colors from before the snapshot. 
+	TArray<FColor> restoredColorsAtLOD0_Local;
+	const bool restoredFromSnapshot_Local = FVertexPaintSnapshotRestore::Get().RestoreComponentIfPending(meshComponent, &restoredColorsAtLOD0_Local);
 
-		FVertexDetectMeshDataPerLODStruct meshDataPerLodTemp;
-		meshDataPerLodTemp.lod = 0;
-		meshDataPerLodTemp.meshVertexColorsPerLODArray = GetDynamicMeshVertexColors(dynamicMeshComponent);
+	// If the colors are in cold storage they're decompressed back into the component here on the Game Thread once, instead of by every LOD task
+	FVertexColorsColdStorage::Get().WarmUp(meshComponent);
 
-		// If actually got any colors, i.e. the lod was valid
-		if (meshDataPerLodTemp.meshVertexColorsPerLODArray.Num() > 0)
-			meshDataPerLod_Local.Add(meshDataPerLodTemp);
+	// Each LOD is read straight into its own slot, in parallel if there are several, and the colors are copied once from the components buffers into the array that ends up in the result. The Game Thread waits for all of them so the component can't change while they're being read. 
+	ParallelFor(meshDataPerLod_Local.Num(), [&](int32 lodIndex) {
 
-		vertexMeshData_Local.meshDataPerLOD = meshDataPerLod_Local;
-		success = true;
-	}
+		meshDataPerLod_Local[lodIndex].lod = lodIndex;
 
-	else if (auto geometryCollectionComponent = Cast<UGeometryCollectionComponent>(meshComponent)) {
+		if (lodIndex == 0 && restoredFromSnapshot_Local) {
 
+			meshDataPerLod_Local[lodIndex].meshVertexColorsPerLODArray = MoveTemp(restoredColorsAtLOD0_Local);
+		}
 
-		vertexMeshData_Local.meshComp = geometryCollectionComponent;
-		vertexMeshData_Local.meshSource = geometryCollectionComponent->GetRestCollection();
+		else {
 
-		FVertexDetectMeshDataPerLODStruct meshDataPerLodTemp;
-		meshDataPerLodTemp.lod = 0;
-		meshDataPerLodTemp.meshVertexColorsPerLODArray = GetGeometryCollectionVertexColors(geometryCollectionComponent);
+			meshDataPerLod_Local[lodIndex].meshVertexColorsPerLODArray = FVertexColorsReadView::Create(meshComponent, lodIndex).MoveToArray();
+		}
+	}, meshDataPerLod_Local.Num() <= 1);
 
-		// If actually got any colors, i.e. the lod was valid
-		if (meshDataPerLodTemp.meshVertexColorsPerLODArray.Num() > 0)
-			meshDataPerLod_Local.Add(meshDataPerLodTemp);
 
-		vertexMeshData_Local.meshDataPerLOD = meshDataPerLod_Local;
-		success = true;
-	}
+	// If didn't get any colors, i.e. the lod wasn't valid
+	meshDataPerLod_Local.RemoveAll([](const FVertexDetectMeshDataPerLODStruct& meshDataPerLodTemp) {
+		return meshDataPerLodTemp.meshVertexColorsPerLODArray.Num() <= 0;
+		});
 
-#endif
+	vertexMeshData_Local.meshDataPerLOD = MoveTemp(meshDataPerLod_Local);
+	success = true;
 
-	return FVertexDetectMeshDataStruct();
+	return vertexMeshData_Local;
 }
 
-
 //--------------------------------------------------------
 
 // Get Mesh Component Vertex Colors At Specific LOD
@@ -1608,6 +2819,28 @@ TArray<FColor> VertexPaintFunctions::GetMeshComponentVertexColorsAtLOD_Wrapper(U
 }
 
 
+//--------------------------------------------------------
+
+// Get Mesh Component Vertex Colors Snapshot At LOD
+
+FVertexColorsSnapshotRef VertexPaintFunctions::GetMeshComponentVertexColorsSnapshotAtLOD(UPrimitiveComponent* meshComponent, int lod) {
+
+	if (!IsValid(meshComponent)) return MakeVertexColorsSnapshot(TArray<FColor>());
+
+
+	// The snapshot can be shared between any amount of async requests without more copies, and between components of the same mesh with identical colors, e.g. props that got the same color snippet. If the component hasn't been painted since its last snapshot it just gets that one again. 
+	const uint64 colorsGeneration_Local = FVertexColorsGenerations::Get().GetGeneration(meshComponent, lod);
+
+	// If the colors hasn't changed since the last snapshot we don't even have to read them
+	if (FVertexColorsSnapshotPtr vertexColorsSnapshot_Local = FVertexColorsSnapshotDedupCache::Get().FindComponentColorsAtGeneration(meshComponent, lod, colorsGeneration_Local))
+		return vertexColorsSnapshot_Local.ToSharedRef();
+
+	const FVertexColorsReadView vertexColorsReadView_Local = FVertexColorsReadView::Create(meshComponent, lod);
+
+	return FVertexColorsSnapshotDedupCache::Get().FindOrAddComponentColors(meshComponent, GetMeshComponentSourceMesh(meshComponent), lod, vertexColorsReadView_Local.GetColors(), colorsGeneration_Local);
+}
+
+
 //--------------------------------------------------------
 
 // Get Skeletal Mesh Vertex Colors At LOD
@@ -1616,104 +2849,98 @@ TArray<FColor> VertexPaintFunctions::GetSkeletalMeshVertexColorsAtLOD(USkeletalM
 
 	if (!IsValid(skeletalMeshComponent)) return TArray<FColor>();
 
+	// The view resolves Override Vertex Colors or the Render Data colors, and fills with White for meshes that got imported with White and hasn't been painted, where the buffer can have no colors. So the only copy here is the one into the array we return. 
+	return FVertexColorsReadView::Create(skeletalMeshComponent, lod).MoveToArray();
+}
 
-	TArray<FColor> colorFromLOD_Local;
-
-	if (skeletalMeshComponent->LODInfo.IsValidIndex(lod)) {
-
-		// If been painted on before then can get the current Instance Color
-		if (skeletalMeshComponent->LODInfo[lod].OverrideVertexColors) {
 
-			skeletalMeshComponent->LODInfo[lod].OverrideVertexColors->GetVertexColors(colorFromLOD_Local);
-		}
-		else {
+//--------------------------------------------------------
 
-			if (skeletalMeshComponent->GetSkeletalMeshRenderData()->LODRenderData.IsValidIndex(lod))
-				skeletalMeshComponent->GetSkeletalMeshRenderData()->LODRenderData[lod].StaticVertexBuffers.ColorVertexBuffer.GetVertexColors(colorFromLOD_Local);
-		}
-	}
+// Get Static Mesh Vertex Colors At LOD
 
-	else {
+TArray<FColor> VertexPaintFunctions::GetStaticMeshVertexColorsAtLOD(UStaticMeshComponent* staticMeshComponent, int lod) {
 
-		if (skeletalMeshComponent->GetSkeletalMeshRenderData()->LODRenderData.IsValidIndex(lod))
-			skeletalMeshComponent->GetSkeletalMeshRenderData()->LODRenderData[lod].StaticVertexBuffers.ColorVertexBuffer.GetVertexColors(colorFromLOD_Local);
-	}
+	if (!IsValid(staticMeshComponent)) return TArray<FColor>();
 
+	// Gets the instanced colors from Override Vertex Colors if painted, otherwise the meshes color buffer, or White if it's uninitialized so unpainted cpu meshes can still be painted and look as they should. Copied straight into an array of the right size instead of it first being initialized and then refilled. 
+	return FVertexColorsReadView::Create(staticMeshComponent, lod).MoveToArray();
+}
 
-	// In one instance when i tested on a side project with a purchased character, it got 0 in Num when first time painting at it, i.e. got vertex colors from SkeletalMeshRenderData. This only occured if the character hadn't gotten any paint on it and was imported with FColor(255,255,255,255) so it was an easy solution to just fill arrays to that color in this rare instance. So unlike the static mesh solution i couldn't initialize colorFromLOD_Local to be a length before running GetVertexColors because then i couldn't detect this rare case. 
-	if (colorFromLOD_Local.Num() > 0) {
 
-		// 
-	}
+//--------------------------------------------------------
 
-	else {
+// Get Mesh Component Vertex Colors Read View At LOD
 
-		if (skeletalMeshComponent->GetSkeletalMeshRenderData()->LODRenderData.IsValidIndex(lod))
-			colorFromLOD_Local.Init(FColor(255, 255, 255, 255), skeletalMeshComponent->GetSkeletalMeshRenderData()->LODRenderData[lod].GetNumVertices());
-	}
+FVertexColorsReadView VertexPaintFunctions::GetMeshComponentVertexColorsReadViewAtLOD(UPrimitiveComponent* meshComponent, int lod) {
 
-	return colorFromLOD_Local;
+	// For read only things like detection, stats and saving, where static and skeletal meshes colors can be looked at where they are instead of being copied
+	return FVertexColorsReadView::Create(meshComponent, lod);
 }
 
 
 //--------------------------------------------------------
 
-// Get Static Mesh Vertex Colors At LOD
+// Get Mesh Component Vertex Colors At LOD Into Buffer
 
-TArray<FColor> VertexPaintFunctions::GetStaticMeshVertexColorsAtLOD(UStaticMeshComponent* staticMeshComponent, int lod) {
+bool VertexPaintFunctions::GetMeshComponentVertexColorsAtLODIntoBuffer(UPrimitiveComponent* meshComponent, int lod, TArray<FColor>& vertexColors) {
 
-	if (!IsValid(staticMeshComponent)) return TArray<FColor>();
-	if (!IsValid(staticMeshComponent->GetStaticMesh())) return TArray<FColor>();
-	if (!staticMeshComponent->GetStaticMesh()->bAllowCPUAccess) return TArray<FColor>();
-	if (!staticMeshComponent->GetStaticMesh()->GetRenderData()->LODResources.IsValidIndex(lod)) return TArray<FColor>();
+	vertexColors.Reset();
 
+	FVertexColorsReadView vertexColorsReadView_Local = FVertexColorsReadView::Create(meshComponent, lod);
 
-	TArray<FColor> colorFromLOD_Local;
-	FColorVertexBuffer* colVertBufferAtLOD_Local = nullptr;
-	int meshLODTotalAmountOfVerts_Local = staticMeshComponent->GetStaticMesh()->GetRenderData()->LODResources[lod].VertexBuffers.PositionVertexBuffer.GetNumVertices();
+	if (vertexColorsReadView_Local.Num() <= 0) return false;
 
-	colorFromLOD_Local.SetNum(meshLODTotalAmountOfVerts_Local, true);
 
-	// Depending if override vertex colors is valid, we get the Vertex Colors from it, i.e. the instanced colors
-	if (staticMeshComponent->LODData.IsValidIndex(lod)) {
+	// Fills the buffer we already have, also for Uniform views and Dynamic Meshes and Geometry Collections that are converted straight into it, instead of allocating an array the view would've filled in first
+	vertexColors.SetNumUninitialized(vertexColorsReadView_Local.Num());
+	vertexColorsReadView_Local.CopyTo(vertexColors);
 
-		if (staticMeshComponent->LODData[lod].OverrideVertexColors) {
+	return true;
+}
 
-			staticMeshComponent->LODData[lod].OverrideVertexColors->GetVertexColors(colorFromLOD_Local);
-		}
 
-		else {
+//--------------------------------------------------------
 
-			staticMeshComponent->GetStaticMesh()->GetRenderData()->LODResources[lod].VertexBuffers.ColorVertexBuffer.GetVertexColors(colorFromLOD_Local);
-		}
-	}
+// Get Mesh Components Vertex Colors At LOD Bulk
 
-	else {
+bool VertexPaintFunctions::GetMeshComponentsVertexColorsAtLODBulk(const TArray<UPrimitiveComponent*>& meshComponents, int lod, FVertexColorsBulkReadback& bulkReadback) {
 
-		colVertBufferAtLOD_Local = &staticMeshComponent->GetStaticMesh()->GetRenderData()->LODResources[lod].VertexBuffers.ColorVertexBuffer;
+	bulkReadback.Reset();
 
-		// If color buffer isn't initialized it means its default colors are White and it hasn't been painted either in editor or in runtime, if this is the case we init the array with white so even unstored, unpainted cpu meshes with all default white vertex colors can be painted and look as they should. 
-		if (colVertBufferAtLOD_Local) {
+	if (meshComponents.Num() <= 0) return false;
 
-			if (colVertBufferAtLOD_Local->IsInitialized()) {
 
-				colVertBufferAtLOD_Local->GetVertexColors(colorFromLOD_Local);
-			}
-			else {
+	// Resolves every component first so we know the total amount and can allocate the block once, then copies each of them straight into its range
+	TArray<FVertexColorsReadView> vertexColorsReadViews_Local;
+	vertexColorsReadViews_Local.Reserve(meshComponents.Num());
 
-				colorFromLOD_Local.Init(FColor::White, meshLODTotalAmountOfVerts_Local);
-			}
-		}
+	bulkReadback.componentFirstVertex.Reserve(meshComponents.Num() + 1);
+	bulkReadback.componentFirstVertex.Add(0);
 
-		else {
+	int64 totalAmountOfVertices_Local = 0;
+
+	for (UPrimitiveComponent* meshComponentTemp : meshComponents) {
 
-			colorFromLOD_Local.Init(FColor::White, meshLODTotalAmountOfVerts_Local);
+		vertexColorsReadViews_Local.Add(FVertexColorsReadView::Create(meshComponentTemp, lod));
+		totalAmountOfVertices_Local += vertexColorsReadViews_Local.Last().Num();
+
+		if (totalAmountOfVertices_Local > MAX_int32) {
+
+			bulkReadback.Reset();
+			return false;
 		}
+
+		bulkReadback.componentFirstVertex.Add(static_cast<int32>(totalAmountOfVertices_Local));
 	}
 
-	return colorFromLOD_Local;
-}
+	bulkReadback.vertexColors.SetNumUninitialized(static_cast<int32>(totalAmountOfVertices_Local));
 
+	// Dynamic Meshes and Geometry Collections are converted straight into their range as well
+	for (int32 i = 0; i < vertexColorsReadViews_Local.Num(); i++)
+		vertexColorsReadViews_Local[i].CopyTo(TArrayView<FColor>(bulkReadback.vertexColors.GetData() + bulkReadback.componentFirstVertex[i], vertexColorsReadViews_Local[i].Num()));
+
+	return totalAmountOfVertices_Local > 0;
+}
 
 //--------------------------------------------------------
 
@@ -1736,34 +2963,104 @@ UVertexPaintDetectionTaskQueue* VertexPaintFunctions::GetVertexPaintTaskQueue(co
 TArray<FColor> VertexPaintFunctions::GetDynamicMeshVertexColors(UDynamicMeshComponent* dynamicMeshComponent) {
 
 	TArray<FColor> colorFromLOD_Local;
+	colorFromLOD_Local.SetNumUninitialized(GetDynamicMeshAmountOfVertexColors(dynamicMeshComponent));
 
-	if (IsValid(dynamicMeshComponent)) {
+	GetDynamicMeshVertexColors(dynamicMeshComponent, colorFromLOD_Local);
 
-		if (dynamicMeshComponent->GetDynamicMesh()) {
+	return colorFromLOD_Local;
+}
 
-			UE::Geometry::FDynamicMesh3* dynamicMesh3 = nullptr;
-			dynamicMesh3 = &dynamicMeshComponent->GetDynamicMesh()->GetMeshRef();
 
-			if (dynamicMesh3) {
+// Indexed by Vertex ID so it lines up with the rest of the dynamic mesh functions, so it's the Max Vertex ID and not the amount of vertices if the mesh has holes
+int32 VertexPaintFunctions::GetDynamicMeshAmountOfVertexColors(UDynamicMeshComponent* dynamicMeshComponent) {
 
-				UE::Geometry::FVertexInfo vertexInfoTemp;
-				colorFromLOD_Local.SetNumUninitialized(dynamicMesh3->MaxVertexID(), false);
+	if (!IsValid(dynamicMeshComponent)) return 0;
+	if (!dynamicMeshComponent->GetDynamicMesh()) return 0;
 
-				for (int i = 0; i < dynamicMesh3->MaxVertexID(); i++) {
+	return FMath::Max(0, dynamicMeshComponent->GetDynamicMesh()->GetMeshRef().MaxVertexID());
+}
 
-					vertexInfoTemp = UE::Geometry::FVertexInfo();
-					vertexInfoTemp = dynamicMesh3->GetVertexInfo(i);
 
-					if (vertexInfoTemp.bHaveC)
-						colorFromLOD_Local[i] = (FColor(vertexInfoTemp.Color.X, vertexInfoTemp.Color.Y, vertexInfoTemp.Color.Z, 0));
-				}
-			}
+// Writes straight into memory the caller owns, e.g. a reused buffer or the range of a component in a bulk read, instead of an array of its own. vertexColors should be GetDynamicMeshAmountOfVertexColors long. 
+void VertexPaintFunctions::GetDynamicMeshVertexColors(UDynamicMeshComponent* dynamicMeshComponent, TArrayView<FColor> vertexColors) {
+
+	if (vertexColors.Num() <= 0) return;
+
+	// IDs that are holes, i.e. removed vertices, and meshes without vertex colors gets 0 instead of being left uninitialized
+	FMemory::Memzero(vertexColors.GetData(), vertexColors.Num() * sizeof(FColor));
+
+	if (!IsValid(dynamicMeshComponent)) return;
+	if (!dynamicMeshComponent->GetDynamicMesh()) return;
+
+
+	const UE::Geometry::FDynamicMesh3& dynamicMesh3_Local = dynamicMeshComponent->GetDynamicMesh()->GetMeshRef();
+	const int32 maxVertexID_Local = FMath::Min(dynamicMesh3_Local.MaxVertexID(), vertexColors.Num());
+
+	if (maxVertexID_Local <= 0) return;
+	if (!dynamicMesh3_Local.HasVertexColors()) return;
+
+
+	// Only reads the vertex color attribute instead of GetVertexInfo that gathers position, normal and uv as well. The colors are stored as 0-255 in the vector, same as we Enable them with, so they're just truncated like before. 
+	const int32 chunkSize_Local = 65536;
+
+	if (maxVertexID_Local < chunkSize_Local * 2) {
+
+		for (int32 vertexID : dynamicMesh3_Local.VertexIndicesItr()) {
+
+			if (vertexID >= maxVertexID_Local) continue;
+
+			const FVector3f vertexColor_Local = dynamicMesh3_Local.GetVertexColor(vertexID);
+			vertexColors[vertexID] = FColor(static_cast<uint8>(vertexColor_Local.X), static_cast<uint8>(vertexColor_Local.Y), static_cast<uint8>(vertexColor_Local.Z), 0);
 		}
 	}
 
-	return colorFromLOD_Local;
+	else {
+
+		// Each chunk writes to its own range of IDs so they don't need to sync. The Game Thread waits so the mesh can't be changed while we read it. 
+		const int32 amountOfChunks_Local = FMath::DivideAndRoundUp(maxVertexID_Local, chunkSize_Local);
+		FColor* vertexColorsData_Local = vertexColors.GetData();
+
+		ParallelFor(amountOfChunks_Local, [&](int32 chunkIndex) {
+
+			const int32 chunkEnd_Local = FMath::Min(maxVertexID_Local, (chunkIndex + 1) * chunkSize_Local);
+
+			for (int32 vertexID = chunkIndex * chunkSize_Local; vertexID < chunkEnd_Local; vertexID++) {
+
+				if (!dynamicMesh3_Local.IsVertex(vertexID)) continue;
+
+				const FVector3f vertexColor_Local = dynamicMesh3_Local.GetVertexColor(vertexID);
+				vertexColorsData_Local[vertexID] = FColor(static_cast<uint8>(vertexColor_Local.X), static_cast<uint8>(vertexColor_Local.Y), static_cast<uint8>(vertexColor_Local.Z), 0);
+			}
+		});
+	}
+}
+
+
+//--------------------------------------------------------
+
+// Convert Linear Colors To Colors
+
+#if ENGINE_MINOR_VERSION >= 3
+
+// Same result as FLinearColor::ToFColor(false), i.e. clamped to 0-1 and floored after scaling by 255.999, but a whole color at a time. Min before Max so NaN ends up as 1 like with FMath::Clamp. 
+static void ConvertLinearColorsToColors(const FLinearColor* linearColors, FColor* colors, int32 amountOfColors) {
+
+	const VectorRegister4Float zero_Local = VectorZeroFloat();
+	const VectorRegister4Float one_Local = VectorOneFloat();
+	const VectorRegister4Float scale_Local = VectorSetFloat1(255.999f);
+
+	for (int32 i = 0; i < amountOfColors; i++) {
+
+		VectorRegister4Float linearColor_Local = VectorLoad(&linearColors[i].R);
+		linearColor_Local = VectorMultiply(VectorMax(VectorMin(linearColor_Local, one_Local), zero_Local), scale_Local);
+
+		// FColor is stored as BGRA, and storing as bytes truncates which is the same as flooring since they're never negative here
+		VectorStoreByte4(VectorSwizzle(linearColor_Local, 2, 1, 0, 3), &colors[i]);
+	}
 }
 
+#endif
+
 
 //--------------------------------------------------------
 
@@ -1772,10 +3069,44 @@ TArray<FColor> VertexPaintFunctions::GetDynamicMeshVertexColors(UDynamicMeshComp
 TArray<FColor> VertexPaintFunctions::GetGeometryCollectionVertexColors(UGeometryCollectionComponent* geometryCollectionComponent) {
 
 	TArray<FColor> colorFromLOD_Local;
+	colorFromLOD_Local.SetNumUninitialized(GetGeometryCollectionAmountOfVertexColors(geometryCollectionComponent));
+
+	GetGeometryCollectionVertexColors(geometryCollectionComponent, colorFromLOD_Local);
+
+	return colorFromLOD_Local;
+}
+
 
+int32 VertexPaintFunctions::GetGeometryCollectionAmountOfVertexColors(UGeometryCollectionComponent* geometryCollectionComponent) {
 
 	// Geometry Collection Only available from 5.3 and up
 
+#if ENGINE_MINOR_VERSION >= 3
+
+	if (!IsValid(geometryCollectionComponent)) return 0;
+
+	UGeometryCollection* geometryCollection = const_cast<UGeometryCollection*>(geometryCollectionComponent->GetRestCollection());
+
+	if (!geometryCollection) return 0;
+
+	TSharedPtr<FGeometryCollection, ESPMode::ThreadSafe> geometryCollectionData = geometryCollection->GetGeometryCollection();
+
+	return geometryCollectionData.Get() ? geometryCollectionData->Color.Num() : 0;
+
+#else
+
+	return 0;
+
+#endif
+}
+
+
+// Writes straight into memory the caller owns, e.g. a reused buffer or the range of a component in a bulk read, instead of an array of its own. vertexColors should be GetGeometryCollectionAmountOfVertexColors long. 
+void VertexPaintFunctions::GetGeometryCollectionVertexColors(UGeometryCollectionComponent* geometryCollectionComponent, TArrayView<FColor> vertexColors) {
+
+	if (vertexColors.Num() <= 0) return;
+
+
 #if ENGINE_MINOR_VERSION >= 3
 
 	if (IsValid(geometryCollectionComponent)) {
@@ -1788,15 +3119,33 @@ TArray<FColor> VertexPaintFunctions::GetGeometryCollectionVertexColors(UGeometry
 
 			if (geometryCollectionData.Get()) {
 
-				for (auto colorsTemp : geometryCollectionData->Color)
-					colorFromLOD_Local.Add(colorsTemp.ToFColor(false));
+				const int32 amountOfColors_Local = FMath::Min(geometryCollectionData->Color.Num(), vertexColors.Num());
+				const FLinearColor* linearColors_Local = geometryCollectionData->Color.GetData();
+				FColor* vertexColorsData_Local = vertexColors.GetData();
+
+				// If the collection has changed since the caller got the amount the rest is zeroed instead of being left uninitialized
+				if (amountOfColors_Local < vertexColors.Num())
+					FMemory::Memzero(vertexColorsData_Local + amountOfColors_Local, (vertexColors.Num() - amountOfColors_Local) * sizeof(FColor));
+
+				// Every color written straight into the buffer, in parallel chunks for large collections like fractured buildings
+				const int32 chunkSize_Local = 65536;
+				const int32 amountOfChunks_Local = FMath::DivideAndRoundUp(amountOfColors_Local, chunkSize_Local);
+
+				ParallelFor(amountOfChunks_Local, [&](int32 chunkIndex) {
+
+					const int32 chunkStart_Local = chunkIndex * chunkSize_Local;
+					ConvertLinearColorsToColors(linearColors_Local + chunkStart_Local, vertexColorsData_Local + chunkStart_Local, FMath::Min(chunkSize_Local, amountOfColors_Local - chunkStart_Local));
+
+				}, amountOfColors_Local < chunkSize_Local * 2);
+
+				return;
 			}
 		}
 	}
 
 #endif
 
-	return colorFromLOD_Local;
+	FMemory::Memzero(vertexColors.GetData(), vertexColors.Num() * sizeof(FColor));
 }
 #endif
 
@@ -3696,12 +5045,47 @@ void VertexPaintFunctions::FillCalculateColorsInfoFundementals(const FVertexDete
 }
 
 
+//-------------------------------------------------------
+
+// Paint Task Applied Colors
+
+// Runs first in all of the Paint and Set callbacks, since that is when the task has actually applied its colors to the mesh, unlike when it was queued where other tasks could still read the old colors in between. So anything that has stored a generation with something it computed from the colors will know that it's out of date. 
+
+static void PaintTaskAppliedColors(const FCalculateColorsInfo& calculateColorsInfo) {
+
+	// The task used the colors just now, so cold storage shouldn't count it as idle since it was queued
+	FVertexColorsColdStorage::Get().MarkUsed(calculateColorsInfo.vertexPaintComponent);
+
+	if (!calculateColorsInfo.taskResult.taskSuccessfull || !calculateColorsInfo.paintTaskResult.anyVertexColorGotChanged) return;
+
+	UPrimitiveComponent* meshComponent_Local = calculateColorsInfo.vertexPaintComponent;
+
+	if (!IsValid(meshComponent_Local)) return;
+
+
+	for (int lod = 0; lod < calculateColorsInfo.lodsToLoopThrough; lod++) {
+
+		FVertexColorsGenerations::Get().BumpGeneration(meshComponent_Local, lod);
+
+		// The task result has the colors it applied, so if the stats has been queried for the LOD they're rebuilt from those right away instead of being read back from the mesh on the next query. Otherwise the bumped generation keeps the old ones out of queries. 
+		if (!calculateColorsInfo.taskResult.meshVertexData.meshDataPerLOD.IsValidIndex(lod)) continue;
+
+		FVertexColorChannelsStatsCache::Get().SetColorsIfCached(meshComponent_Local, lod, calculateColorsInfo.taskResult.meshVertexData.meshDataPerLOD[lod].meshVertexColorsPerLODArray);
+
+		// Same with the Channel Planes, for the components that has opted in to them and has been queried
+		FVertexColorChannelPlanesCache::Get().SetColorsIfCached(meshComponent_Local, lod, calculateColorsInfo.taskResult.meshVertexData.meshDataPerLOD[lod].meshVertexColorsPerLODArray);
+	}
+}
+
+
 //-------------------------------------------------------
 
 // Callbacks
 
 void VertexPaintFunctions::RunGetClosestVertexDataCallbacks(const FCalculateColorsInfo& calculateColorsInfo, const FVertexDetectClosestVertexDataResultStruct& closestVertexColorResult, const FVertexDetectEstimatedColorAtHitLocationResultStruct& estimatedColorAtHitLocationResult, const FVertexDetectAvarageColorInAreaInfo& avarageColor) {
 
+	FVertexColorsColdStorage::Get().MarkUsed(calculateColorsInfo.vertexPaintComponent);
+
 	if (IsValid(calculateColorsInfo.initiatedByComponent)) {
 
 		calculateColorsInfo.initiatedByComponent->GetClosestVertexDataOnMeshTaskFinished(calculateColorsInfo, closestVertexColorResult, estimatedColorAtHitLocationResult, avarageColor);
@@ -3727,6 +5111,8 @@ void VertexPaintFunctions::RunGetClosestVertexDataCallbacks(const FCalculateColo
 
 void VertexPaintFunctions::RunGetAllColorsOnlyCallbacks(const FCalculateColorsInfo& calculateColorsInfo) {
 
+	FVertexColorsColdStorage::Get().MarkUsed(calculateColorsInfo.vertexPaintComponent);
+
 
 	if (IsValid(calculateColorsInfo.initiatedByComponent)) {
 
@@ -3754,6 +5140,10 @@ void VertexPaintFunctions::RunGetAllColorsOnlyCallbacks(const FCalculateColorsIn
 
 void VertexPaintFunctions::RunPaintAtLocationCallbacks(const FCalculateColorsInfo& calculateColorsInfo, const FVertexDetectClosestVertexDataResultStruct& closestVertexColorResult, const FVertexDetectEstimatedColorAtHitLocationResultStruct& estimatedColorAtHitLocationResult, const FVertexDetectAvarageColorInAreaInfo& avarageColor) {
 
+	PaintTaskAppliedColors(calculateColorsInfo);
+
+	// So replication knows the oldest recorded command on the component has been applied, even if the task failed
+	FVertexPaintCommandRecorder::Get().RecordPaintTaskFinished(calculateColorsInfo.paintOnMeshAtLocationSettings.meshComponent, calculateColorsInfo.additionalDataToPassThrough.replicatedCommandId);
 
 	if (IsValid(calculateColorsInfo.initiatedByComponent)) {
 
@@ -3789,6 +5179,9 @@ void VertexPaintFunctions::RunPaintAtLocationCallbacks(const FCalculateColorsInf
 
 void VertexPaintFunctions::RunPaintWithinAreaCallbacks(const FCalculateColorsInfo& calculateColorsInfo) {
 
+	PaintTaskAppliedColors(calculateColorsInfo);
+	FVertexPaintCommandRecorder::Get().RecordPaintTaskFinished(calculateColorsInfo.paintOnMeshWithinAreaSettings.meshComponent, calculateColorsInfo.additionalDataToPassThrough.replicatedCommandId);
+
 
 	if (IsValid(calculateColorsInfo.initiatedByComponent)) {
 
@@ -3824,6 +5217,9 @@ void VertexPaintFunctions::RunPaintWithinAreaCallbacks(const FCalculateColorsInf
 
 void VertexPaintFunctions::RunPaintEntireMeshCallbacks(const FCalculateColorsInfo& calculateColorsInfo) {
 
+	PaintTaskAppliedColors(calculateColorsInfo);
+	FVertexPaintCommandRecorder::Get().RecordPaintTaskFinished(calculateColorsInfo.paintOnEntireMeshSettings.meshComponent, calculateColorsInfo.additionalDataToPassThrough.replicatedCommandId);
+
 
 	if (IsValid(calculateColorsInfo.initiatedByComponent)) {
 
@@ -3859,6 +5255,8 @@ void VertexPaintFunctions::RunPaintEntireMeshCallbacks(const FCalculateColorsInf
 
 void VertexPaintFunctions::RunPaintColorSnippetCallbacks(const FCalculateColorsInfo& calculateColorsInfo) {
 
+	PaintTaskAppliedColors(calculateColorsInfo);
+
 
 	if (IsValid(calculateColorsInfo.initiatedByComponent)) {
 
@@ -3894,6 +5292,8 @@ void VertexPaintFunctions::RunPaintColorSnippetCallbacks(const FCalculateColorsI
 
 void VertexPaintFunctions::RunPaintSetMeshColorsCallbacks(const FCalculateColorsInfo& calculateColorsInfo) {
 
+	PaintTaskAppliedColors(calculateColorsInfo);
+
 
 	if (IsValid(calculateColorsInfo.initiatedByComponent)) {
 
@@ -3930,6 +5330,8 @@ void VertexPaintFunctions::RunPaintSetMeshColorsCallbacks(const FCalculateColors
 
 void VertexPaintFunctions::RunPaintSetMeshColorsUsingSerializedStringCallbacks(const FCalculateColorsInfo& calculateColorsInfo) {
 
+	PaintTaskAppliedColors(calculateColorsInfo);
+
 
 	if (IsValid(calculateColorsInfo.initiatedByComponent)) {
 
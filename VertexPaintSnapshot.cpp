@@ -0,0 +1,408 @@
+#include "VertexPaintSnapshot.h"
+#include "VertexColorsBinaryFormat.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/LargeMemoryReader.h"
+#include "HAL/IConsoleManager.h"
+
+
+static TAutoConsoleVariable<int32> CVarVertexPaintSnapshotRestoresPerTick(
+	TEXT("VertexPaint.Snapshot.RestoresPerTick"),
+	8,
+	TEXT("How many components of an open snapshot that are loaded but hasn't been streamed in or queried gets restored in the background each tick. 0 means they're only restored when streamed in or queried. "),
+	ECVF_Default);
+
+
+//-------------------------------------------------------
+
+// Serialize Snapshot Header
+
+static void SerializeVertexPaintSnapshotHeader(FArchive& archive, FVertexPaintSnapshotHeader& header) {
+
+	archive << header.magic;
+	archive << header.version;
+	archive << header.amountOfComponents;
+	archive << header.indexOffset;
+}
+
+
+//-------------------------------------------------------
+
+// Write World Snapshot
+
+bool FVertexPaintSnapshot::WriteWorldSnapshot(const UObject* WorldContextObject, const FString& snapshotFilePath, int32& amountOfComponentsWritten) {
+
+	amountOfComponentsWritten = 0;
+
+	if (!IsValid(WorldContextObject) || !WorldContextObject->GetWorld()) return false;
+
+
+	TUniquePtr<FArchive> fileWriter_Local(IFileManager::Get().CreateFileWriter(*snapshotFilePath));
+
+	if (!fileWriter_Local) return false;
+
+
+	// Written with the index offset once we know it
+	FVertexPaintSnapshotHeader header_Local;
+	SerializeVertexPaintSnapshotHeader(*fileWriter_Local, header_Local);
+
+	TArray<FString> componentPaths_Local;
+	TArray<int64> componentOffsets_Local;
+	TArray<int32> componentLengths_Local;
+	TArray<uint8> binaryColorData_Local;
+
+	for (const auto& paintedMeshTemp : VertexPaintFunctions::GetMeshPaintedSinceSessionStarted_Wrapper(WorldContextObject)) {
+
+		UPrimitiveComponent* meshComponent_Local = paintedMeshTemp.Key;
+
+		// The subsystem is for the whole game instance, so only the ones in this world
+		if (!IsValid(meshComponent_Local) || meshComponent_Local->GetWorld() != WorldContextObject->GetWorld()) continue;
+
+		if (!VertexPaintFunctions::GetMeshComponentVertexColorsAsBinary(meshComponent_Local, true, binaryColorData_Local)) continue;
+
+
+		componentPaths_Local.Add(meshComponent_Local->GetPathName());
+		componentOffsets_Local.Add(fileWriter_Local->Tell());
+		componentLengths_Local.Add(binaryColorData_Local.Num());
+
+		fileWriter_Local->Serialize(binaryColorData_Local.GetData(), binaryColorData_Local.Num());
+	}
+
+
+	header_Local.amountOfComponents = componentPaths_Local.Num();
+	header_Local.indexOffset = fileWriter_Local->Tell();
+
+	for (int32 i = 0; i < componentPaths_Local.Num(); i++) {
+
+		*fileWriter_Local << componentPaths_Local[i];
+		*fileWriter_Local << componentOffsets_Local[i];
+		*fileWriter_Local << componentLengths_Local[i];
+	}
+
+	fileWriter_Local->Seek(0);
+	SerializeVertexPaintSnapshotHeader(*fileWriter_Local, header_Local);
+
+
+	const bool writtenSuccessfully_Local = !fileWriter_Local->IsError() && fileWriter_Local->Close();
+
+	if (writtenSuccessfully_Local)
+		amountOfComponentsWritten = componentPaths_Local.Num();
+
+	return writtenSuccessfully_Local;
+}
+
+
+//-------------------------------------------------------
+
+// Get
+
+FVertexPaintSnapshotRestore& FVertexPaintSnapshotRestore::Get() {
+
+	static FVertexPaintSnapshotRestore vertexPaintSnapshotRestore;
+	return vertexPaintSnapshotRestore;
+}
+
+
+//-------------------------------------------------------
+
+// Open Snapshot
+
+bool FVertexPaintSnapshotRestore::OpenSnapshot(const UObject* WorldContextObject, const FString& snapshotFilePath, const FVertexPaintSetMeshComponentVertexColors& setMeshComponentVertexColorsSettings) {
+
+	if (!IsInGameThread()) return false;
+
+	CloseSnapshot();
+
+	if (!IsValid(WorldContextObject) || !WorldContextObject->GetWorld()) return false;
+
+
+	// Maps the file so a component's colors are only paged in when it gets restored, and the OS can drop them again afterwards
+	mappedFileHandle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*snapshotFilePath));
+
+	if (mappedFileHandle)
+		mappedFileRegion.Reset(mappedFileHandle->MapRegion(0, mappedFileHandle->GetFileSize()));
+
+	if (!mappedFileRegion) {
+
+		mappedFileHandle.Reset();
+
+		if (!FFileHelper::LoadFileToArray(loadedSnapshotBytes, *snapshotFilePath)) return false;
+	}
+
+
+	const TConstArrayView<uint8> snapshotBytes_Local = GetSnapshotBytes();
+
+	FLargeMemoryReader snapshotReader_Local(snapshotBytes_Local.GetData(), snapshotBytes_Local.Num());
+
+	FVertexPaintSnapshotHeader header_Local;
+	SerializeVertexPaintSnapshotHeader(snapshotReader_Local, header_Local);
+
+	if (snapshotReader_Local.IsError() || header_Local.magic != FVertexPaintSnapshotHeader::Magic || header_Local.version == 0 || header_Local.version > FVertexPaintSnapshotHeader::CurrentVersion || header_Local.indexOffset < FVertexPaintSnapshotHeader::SerializedSize || header_Local.indexOffset > snapshotBytes_Local.Num()) {
+
+		CloseSnapshot();
+		return false;
+	}
+
+
+	snapshotReader_Local.Seek(header_Local.indexOffset);
+
+	for (int32 i = 0; i < header_Local.amountOfComponents; i++) {
+
+		FString componentPath_Local;
+		FSnapshotEntry snapshotEntry_Local;
+
+		snapshotReader_Local << componentPath_Local;
+		snapshotReader_Local << snapshotEntry_Local.offset;
+		snapshotReader_Local << snapshotEntry_Local.length;
+
+		if (snapshotReader_Local.IsError()) break;
+
+		// Entries that points outside of where the colors are has to be from a corrupt file
+		if (snapshotEntry_Local.offset < FVertexPaintSnapshotHeader::SerializedSize || snapshotEntry_Local.length <= 0 || snapshotEntry_Local.offset + snapshotEntry_Local.length > header_Local.indexOffset) continue;
+
+		pendingSnapshotEntries.Add(componentPath_Local, snapshotEntry_Local);
+		pendingComponentPaths.Add(componentPath_Local);
+	}
+
+	if (snapshotReader_Local.IsError() || pendingSnapshotEntries.Num() <= 0) {
+
+		CloseSnapshot();
+		return false;
+	}
+
+
+	snapshotWorld = WorldContextObject->GetWorld();
+	restoreSettings = setMeshComponentVertexColorsSettings;
+	restoreOptionalCallbackComponent = setMeshComponentVertexColorsSettings.optionalCallbackComponent;
+
+	restoreSettings.optionalCallbackComponent = nullptr;
+	restoreSettings.meshComponent = nullptr;
+	restoreSettings.actor = nullptr;
+	restoreSettings.taskWorld = nullptr;
+	restoreSettings.debugSettings.worldTaskWasCreatedIn = nullptr;
+
+	levelAddedToWorldHandle = FWorldDelegates::LevelAddedToWorld.AddRaw(this, &FVertexPaintSnapshotRestore::OnLevelAddedToWorld);
+
+#if ENGINE_MAJOR_VERSION == 5
+	tickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FVertexPaintSnapshotRestore::Tick));
+#else
+	tickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FVertexPaintSnapshotRestore::Tick));
+#endif
+
+	return true;
+}
+
+
+//-------------------------------------------------------
+
+// Close Snapshot
+
+void FVertexPaintSnapshotRestore::CloseSnapshot() {
+
+	if (levelAddedToWorldHandle.IsValid()) {
+
+		FWorldDelegates::LevelAddedToWorld.Remove(levelAddedToWorldHandle);
+		levelAddedToWorldHandle.Reset();
+	}
+
+	if (tickerHandle.IsValid()) {
+
+#if ENGINE_MAJOR_VERSION == 5
+		FTSTicker::GetCoreTicker().RemoveTicker(tickerHandle);
+#else
+		FTicker::GetCoreTicker().RemoveTicker(tickerHandle);
+#endif
+
+		tickerHandle.Reset();
+	}
+
+	// The region has to be unmapped before the file handle is closed
+	mappedFileRegion.Reset();
+	mappedFileHandle.Reset();
+	loadedSnapshotBytes.Empty();
+
+	pendingSnapshotEntries.Empty();
+	pendingComponentPaths.Empty();
+	pendingComponentPathIndex = 0;
+	snapshotWorld.Reset();
+	restoreOptionalCallbackComponent.Reset();
+}
+
+
+//-------------------------------------------------------
+
+// Restore Component If Pending
+
+bool FVertexPaintSnapshotRestore::RestoreComponentIfPending(UPrimitiveComponent* meshComponent, TArray<FColor>* restoredColorsAtLOD0) {
+
+	// Early out before building the path, since this is run on every query
+	if (pendingSnapshotEntries.Num() <= 0) return false;
+	if (!IsInGameThread()) return false;
+	if (!IsValid(meshComponent) || meshComponent->GetWorld() != snapshotWorld.Get()) return false;
+
+
+	const FString componentPath_Local = meshComponent->GetPathName();
+	FSnapshotEntry snapshotEntry_Local;
+
+	if (!pendingSnapshotEntries.RemoveAndCopyValue(componentPath_Local, snapshotEntry_Local)) return false;
+
+	const bool restored_Local = RestoreComponent(meshComponent, snapshotEntry_Local, restoredColorsAtLOD0);
+
+	if (pendingSnapshotEntries.Num() <= 0)
+		CloseSnapshot();
+
+	return restored_Local;
+}
+
+
+//-------------------------------------------------------
+
+// Remove Component If Pending
+
+bool FVertexPaintSnapshotRestore::RemoveComponentIfPending(UPrimitiveComponent* meshComponent) {
+
+	if (pendingSnapshotEntries.Num() <= 0) return false;
+	if (!IsInGameThread()) return false;
+	if (!IsValid(meshComponent) || meshComponent->GetWorld() != snapshotWorld.Get()) return false;
+
+
+	// The background restore skips paths that are no longer pending, so it's only removed from the entries
+	if (pendingSnapshotEntries.Remove(meshComponent->GetPathName()) <= 0) return false;
+
+	if (pendingSnapshotEntries.Num() <= 0)
+		CloseSnapshot();
+
+	return true;
+}
+
+
+//-------------------------------------------------------
+
+// Restore Component
+
+bool FVertexPaintSnapshotRestore::RestoreComponent(UPrimitiveComponent* meshComponent, const FSnapshotEntry& snapshotEntry, TArray<FColor>* restoredColorsAtLOD0) {
+
+	const TConstArrayView<uint8> snapshotBytes_Local = GetSnapshotBytes();
+
+	if (snapshotEntry.offset + snapshotEntry.length > snapshotBytes_Local.Num()) return false;
+
+
+	FVertexPaintSetMeshComponentVertexColors setMeshComponentVertexColorsSettings_Local = restoreSettings;
+
+	// If the callback component has been destroyed since the snapshot was opened the rest are restored without callbacks
+	UVertexPaintDetectionComponent* optionalCallbackComponent_Local = restoreOptionalCallbackComponent.Get();
+	setMeshComponentVertexColorsSettings_Local.optionalCallbackComponent = ::IsValid(optionalCallbackComponent_Local) ? optionalCallbackComponent_Local : nullptr;
+
+	// Only the compressed colors of this component are copied out of the mapped file
+	const TArray<uint8> binaryColorData_Local(snapshotBytes_Local.GetData() + snapshotEntry.offset, snapshotEntry.length);
+
+	if (!VertexPaintFunctions::GetVertexColorsFromBinary(meshComponent, binaryColorData_Local, setMeshComponentVertexColorsSettings_Local.vertexColorsAtLOD0ToSet)) return false;
+
+	if (restoredColorsAtLOD0)
+		*restoredColorsAtLOD0 = setMeshComponentVertexColorsSettings_Local.vertexColorsAtLOD0ToSet;
+
+	VertexPaintFunctions::SetMeshComponentVertexColors_Wrapper(meshComponent, MoveTemp(setMeshComponentVertexColorsSettings_Local), FVertexDetectAdditionalDataToPassThrough());
+
+	return true;
+}
+
+
+//-------------------------------------------------------
+
+// On Level Added To World
+
+void FVertexPaintSnapshotRestore::OnLevelAddedToWorld(ULevel* level, UWorld* world) {
+
+	if (!level || world != snapshotWorld.Get()) return;
+
+
+	// Components in the level that just got streamed in are restored right away, so they never show up without their colors
+	TInlineComponentArray<UPrimitiveComponent*> primitiveComponents_Local;
+
+	for (AActor* actorTemp : level->Actors) {
+
+		if (!IsValid(actorTemp)) continue;
+
+		actorTemp->GetComponents(primitiveComponents_Local);
+
+		for (UPrimitiveComponent* primitiveComponentTemp : primitiveComponents_Local) {
+
+			RestoreComponentIfPending(primitiveComponentTemp);
+
+			// Closes itself once everything has been restored
+			if (pendingSnapshotEntries.Num() <= 0) return;
+		}
+	}
+}
+
+
+//-------------------------------------------------------
+
+// Tick
+
+bool FVertexPaintSnapshotRestore::Tick(float deltaTime) {
+
+	const int32 restoresPerTick_Local = CVarVertexPaintSnapshotRestoresPerTick.GetValueOnGameThread();
+
+	if (restoresPerTick_Local <= 0) return true;
+
+	if (!snapshotWorld.IsValid()) {
+
+		CloseSnapshot();
+		return false;
+	}
+
+
+	// Looks through a limited amount of paths each tick so thousands of components that aren't loaded yet doesn't cost anything noticeable
+	const int32 maxPathsToLookThrough_Local = restoresPerTick_Local * 16;
+	int32 amountOfRestores_Local = 0;
+
+	for (int32 i = 0; i < maxPathsToLookThrough_Local && amountOfRestores_Local < restoresPerTick_Local && pendingComponentPaths.Num() > 0; i++) {
+
+		if (pendingComponentPathIndex >= pendingComponentPaths.Num()) {
+
+			// Starts over with only the ones that are still pending
+			pendingComponentPaths.Reset();
+			pendingSnapshotEntries.GenerateKeyArray(pendingComponentPaths);
+			pendingComponentPathIndex = 0;
+			continue;
+		}
+
+		const FString& componentPath_Local = pendingComponentPaths[pendingComponentPathIndex++];
+
+		if (!pendingSnapshotEntries.Contains(componentPath_Local)) continue;
+
+
+		// Only finds it if it's already loaded, it's never loaded because of this
+		UPrimitiveComponent* meshComponent_Local = Cast<UPrimitiveComponent>(FSoftObjectPath(componentPath_Local).ResolveObject());
+
+		if (!IsValid(meshComponent_Local)) continue;
+
+		if (RestoreComponentIfPending(meshComponent_Local))
+			amountOfRestores_Local++;
+
+		// Restoring the last one closes the snapshot, which removes this ticker
+		if (pendingSnapshotEntries.Num() <= 0) return false;
+	}
+
+	return true;
+}
+
+
+//-------------------------------------------------------
+
+// Get Snapshot Bytes
+
+TConstArrayView<uint8> FVertexPaintSnapshotRestore::GetSnapshotBytes() const {
+
+	if (mappedFileRegion)
+		return TConstArrayView<uint8>(mappedFileRegion->GetMappedPtr(), mappedFileRegion->GetMappedSize());
+
+	return loadedSnapshotBytes;
+}
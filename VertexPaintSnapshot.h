@@ -0,0 +1,112 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "VertexPaintFunctionLibrary.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+class ULevel;
+class UWorld;
+
+
+//-------------------------------------------------------
+
+// Vertex Paint Snapshot
+
+// Every painted component in a world saved to one file instead of one save entry per mesh. The file is a header, then each component's LOD0 colors in the binary vertex colors format, then an index from component path to where its colors are in the file, so a component's colors can be found without reading the others. 
+
+struct FVertexPaintSnapshotHeader {
+
+	static const uint32 Magic = 0x46535056; // VPSF
+	static const uint16 CurrentVersion = 1;
+
+	uint32 magic = Magic;
+	uint16 version = CurrentVersion;
+	int32 amountOfComponents = 0;
+	int64 indexOffset = 0;
+
+	static constexpr int32 SerializedSize = 4 + 2 + 4 + 8;
+};
+
+
+class FVertexPaintSnapshot {
+
+public:
+
+	// Writes every component in the world that has been painted since the session started. Returns false if the file couldn't be written. 
+	static bool WriteWorldSnapshot(const UObject* WorldContextObject, const FString& snapshotFilePath, int32& amountOfComponentsWritten);
+};
+
+
+//-------------------------------------------------------
+
+// Vertex Paint Snapshot Restore
+
+// Restores a snapshot lazily instead of queueing a task for every component in it at once. The file is memory mapped and only its index is read up front. A component's colors are decoded and Set when its level is streamed in, when its colors are first queried, or a few per tick in the background for components that are already loaded. Everything runs on the Game Thread. 
+
+class FVertexPaintSnapshotRestore {
+
+public:
+
+	static FVertexPaintSnapshotRestore& Get();
+
+	// Closes any snapshot that was already open. setMeshComponentVertexColorsSettings is used for every Set task that restores a component, so callbacks and debug settings can be set on it. 
+	bool OpenSnapshot(const UObject* WorldContextObject, const FString& snapshotFilePath, const FVertexPaintSetMeshComponentVertexColors& setMeshComponentVertexColorsSettings);
+
+	void CloseSnapshot();
+
+	int32 GetAmountOfPendingComponents() const { return pendingSnapshotEntries.Num(); }
+
+	// Queues the Set task for the component if it's in the snapshot and hasn't been restored yet. If restoredColorsAtLOD0 is passed in it gets the snapshot colors, so a query doesn't have to wait for the task to see them. 
+	// Only LOD0 is in the snapshot, the other LODs gets it propagated to them by the Set task, so until it has run they still have the colors from before the snapshot. 
+	bool RestoreComponentIfPending(UPrimitiveComponent* meshComponent, TArray<FColor>* restoredColorsAtLOD0 = nullptr);
+
+	// For when every color of the component is about to be Set anyway, so restoring it would only be overwritten. Returns true if it was pending. 
+	bool RemoveComponentIfPending(UPrimitiveComponent* meshComponent);
+
+
+private:
+
+	struct FSnapshotEntry {
+
+		int64 offset = 0;
+		int32 length = 0;
+	};
+
+	bool Tick(float deltaTime);
+
+	void OnLevelAddedToWorld(ULevel* level, UWorld* world);
+
+	bool RestoreComponent(UPrimitiveComponent* meshComponent, const FSnapshotEntry& snapshotEntry, TArray<FColor>* restoredColorsAtLOD0);
+
+	TConstArrayView<uint8> GetSnapshotBytes() const;
+
+
+	TUniquePtr<IMappedFileHandle> mappedFileHandle;
+	TUniquePtr<IMappedFileRegion> mappedFileRegion;
+
+	// If the platform can't memory map the file it's loaded into this instead
+	TArray<uint8> loadedSnapshotBytes;
+
+	TWeakObjectPtr<UWorld> snapshotWorld;
+
+	// Without any of its UObjects since we aren't a UObject and can't keep them from being garbage collected. The Set wrapper fills in the component, actor and world for each restore, and the callback component is kept weak and checked every time. 
+	FVertexPaintSetMeshComponentVertexColors restoreSettings;
+	TWeakObjectPtr<UVertexPaintDetectionComponent> restoreOptionalCallbackComponent;
+
+	TMap<FString, FSnapshotEntry> pendingSnapshotEntries;
+
+	// The order the background restore goes through the pending components in, picking up where it left off each tick
+	TArray<FString> pendingComponentPaths;
+	int32 pendingComponentPathIndex = 0;
+
+	FDelegateHandle levelAddedToWorldHandle;
+
+#if ENGINE_MAJOR_VERSION == 5
+	FTSTicker::FDelegateHandle tickerHandle;
+#else
+	FDelegateHandle tickerHandle;
+#endif
+};
@@ -0,0 +1,530 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "VertexPaintFunctionLibrary.h"
+#include "VertexPaintCommandReplication.h"
+#include "VertexColorsSerializedString.h"
+#include "VertexColorsPatch.h"
+#include "VertexColorsBinaryFormat.h"
+#include "VertexColorsColdStorage.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Components/StaticMeshComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+#include "Math/RandomStream.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+#if ENGINE_MAJOR_VERSION == 5
+#include "Components/DynamicMeshComponent.h"
+#include "UDynamicMesh.h"
+#include "DynamicMesh/DynamicMesh3.h"
+#endif
+
+
+// Tests for the parts of the plugin that can be checked without a GPU, assets or running any paint tasks, e.g. the replication ordering and the binary formats. Can be run on a build machine with something like:
+// UnrealEditor-Cmd <Project> -ExecCmds="Automation RunTests VertexPaint.Tests; Quit" -nullrhi -unattended -nosplash
+
+
+//-------------------------------------------------------
+
+// Vertex Paint Test Command Replayer
+
+// Records what would have been replayed instead of running the tasks, using the Red Color of each command to tell them apart
+
+class FVertexPaintTestCommandReplayer : public FVertexPaintCommandReplayer {
+
+public:
+
+	explicit FVertexPaintTestCommandReplayer(UWorld* world) : FVertexPaintCommandReplayer(world, nullptr) {}
+
+	TArray<int32> replayedRedColors;
+	int32 amountOfAppliedCheckpoints = 0;
+
+
+protected:
+
+	virtual void ReplayCommand(UPrimitiveComponent* meshComponent, EVertexPaintReplicatedCommandType commandType, const TArray<uint8>& serializedSettings) override {
+
+		FMemoryReader memoryReader_Local(serializedSettings);
+		FObjectAndNameAsStringProxyArchive settingsReader_Local(memoryReader_Local, false);
+
+		FVertexPaintAtLocationStruct paintAtLocationStruct_Local;
+		FVertexPaintAtLocationStruct::StaticStruct()->SerializeBin(settingsReader_Local, &paintAtLocationStruct_Local);
+
+		replayedRedColors.Add(static_cast<int32>(paintAtLocationStruct_Local.applyVertexColorSettings.redColor));
+	}
+
+	virtual void ApplyCheckpoint(UPrimitiveComponent* meshComponent, const TArray<uint8>& binaryColorData) override {
+
+		amountOfAppliedCheckpoints++;
+	}
+};
+
+
+//-------------------------------------------------------
+
+// Vertex Paint Command Replication Test
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVertexPaintCommandReplicationTest, "VertexPaint.Tests.CommandReplication", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FVertexPaintCommandReplicationTest::RunTest(const FString& Parameters) {
+
+	// Checkpoints needs colors to read, which a component without a mesh doesn't have, so they're turned off and only the ordering of the commands is tested
+	IConsoleVariable* checkpointIntervalCVar_Local = IConsoleManager::Get().FindConsoleVariable(TEXT("VertexPaint.Replication.CheckpointInterval"));
+	const int32 checkpointInterval_Local = checkpointIntervalCVar_Local ? checkpointIntervalCVar_Local->GetInt() : 0;
+
+	if (checkpointIntervalCVar_Local)
+		checkpointIntervalCVar_Local->Set(0, ECVF_SetByCode);
+
+
+	UWorld* world_Local = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& worldContext_Local = GEngine->CreateNewWorldContext(EWorldType::Game);
+	worldContext_Local.SetCurrentWorld(world_Local);
+
+	AActor* actor_Local = world_Local->SpawnActor<AActor>();
+	UStaticMeshComponent* meshComponent_Local = NewObject<UStaticMeshComponent>(actor_Local, TEXT("ReplicationTestMesh"));
+
+	TSharedPtr<FVertexPaintTestCommandReplayer> replayer_Local = MakeShared<FVertexPaintTestCommandReplayer>(world_Local);
+	TSharedPtr<FVertexPaintLoopbackTransport> loopbackTransport_Local = MakeShared<FVertexPaintLoopbackTransport>(replayer_Local);
+
+	FVertexPaintCommandRecorder& recorder_Local = FVertexPaintCommandRecorder::Get();
+	recorder_Local.StartRecording(world_Local, loopbackTransport_Local);
+
+
+	for (int32 i = 0; i < 6; i++) {
+
+		FVertexPaintAtLocationStruct paintAtLocationStruct_Local;
+		paintAtLocationStruct_Local.applyVertexColorSettings.redColor = i;
+
+		recorder_Local.RecordPaintOnMeshAtLocation(meshComponent_Local, paintAtLocationStruct_Local);
+	}
+
+	TestEqual(TEXT("Every command is sent"), loopbackTransport_Local->GetQueuedMessages().Num(), 6);
+
+
+	// Out of order, with a duplicate, and the command with sequence 2 dropped
+	const TArray<TArray<uint8>> sentMessages_Local = loopbackTransport_Local->GetQueuedMessages();
+	loopbackTransport_Local->GetQueuedMessages() = { sentMessages_Local[1], sentMessages_Local[0], sentMessages_Local[0], sentMessages_Local[3], sentMessages_Local[5], sentMessages_Local[4] };
+	loopbackTransport_Local->DeliverMessages();
+
+	TestEqual(TEXT("Replays up to the dropped command, in sequence order and without the duplicate"), replayer_Local->replayedRedColors, TArray<int32>({ 0, 1 }));
+
+
+	// Catching up delivers everything since the last checkpoint again, which fills in the dropped one and the rest are duplicates
+	TArray<TArray<uint8>> catchUpMessages_Local;
+	recorder_Local.GetCatchUpMessages(meshComponent_Local, catchUpMessages_Local);
+
+	TestEqual(TEXT("Catch up has every command since there's no checkpoint"), catchUpMessages_Local.Num(), 6);
+
+	loopbackTransport_Local->GetQueuedMessages() = catchUpMessages_Local;
+	loopbackTransport_Local->DeliverMessages();
+
+	TestEqual(TEXT("Replays the rest once the dropped command arrives"), replayer_Local->replayedRedColors, TArray<int32>({ 0, 1, 2, 3, 4, 5 }));
+
+
+	// Paint at random vertices isn't sent, and the peer waits at its sequence for the checkpoint instead of replaying what comes after it
+	FVertexPaintOnEntireMeshStruct paintOnEntireMeshStruct_Local;
+	paintOnEntireMeshStruct_Local.paintOnRandomVerticesSettings.paintAtRandomVerticesSpreadOutOverTheEntireMesh = true;
+
+	recorder_Local.RecordPaintOnEntireMesh(meshComponent_Local, paintOnEntireMeshStruct_Local);
+
+	TestEqual(TEXT("Paint at random vertices isn't sent as a command"), loopbackTransport_Local->GetQueuedMessages().Num(), 0);
+
+	FVertexPaintAtLocationStruct paintAtLocationStruct_Local;
+	paintAtLocationStruct_Local.applyVertexColorSettings.redColor = 7;
+
+	recorder_Local.RecordPaintOnMeshAtLocation(meshComponent_Local, paintAtLocationStruct_Local);
+	loopbackTransport_Local->DeliverMessages();
+
+	TestEqual(TEXT("Commands after paint at random vertices waits for its checkpoint"), replayer_Local->replayedRedColors.Num(), 6);
+	TestEqual(TEXT("No checkpoints has been applied"), replayer_Local->amountOfAppliedCheckpoints, 0);
+
+
+	recorder_Local.StopRecording();
+
+	GEngine->DestroyWorldContext(world_Local);
+	world_Local->DestroyWorld(false);
+
+	if (checkpointIntervalCVar_Local)
+		checkpointIntervalCVar_Local->Set(checkpointInterval_Local, ECVF_SetByCode);
+
+	return true;
+}
+
+
+//-------------------------------------------------------
+
+// Vertex Colors Serialized String Test
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVertexColorsSerializedStringTest, "VertexPaint.Tests.SerializedString", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FVertexColorsSerializedStringTest::RunTest(const FString& Parameters) {
+
+	FRandomStream randomStream_Local(1337);
+
+	TArray<FColor> vertexColors_Local = { FColor(0, 0, 0, 0), FColor(255, 255, 255, 255), FColor(1, 2, 3, 4), FColor(254, 16, 15, 128) };
+
+	for (int32 i = 0; i < 1000; i++)
+		vertexColors_Local.Add(FColor(randomStream_Local.RandRange(0, 255), randomStream_Local.RandRange(0, 255), randomStream_Local.RandRange(0, 255), randomStream_Local.RandRange(0, 255)));
+
+	const FString serializedColors_Local = FVertexColorsSerializedString::Encode(vertexColors_Local);
+
+	TestEqual(TEXT("Every color is encoded as 8 characters"), serializedColors_Local.Len(), vertexColors_Local.Num() * FVertexColorsSerializedString::CharactersPerColor);
+	TestEqual(TEXT("Colors are encoded the same as FColor::ToHex"), serializedColors_Local.Left(FVertexColorsSerializedString::CharactersPerColor * 4), FColor(0, 0, 0, 0).ToHex() + FColor(255, 255, 255, 255).ToHex() + FColor(1, 2, 3, 4).ToHex() + FColor(254, 16, 15, 128).ToHex());
+
+
+	TArray<FColor> decodedColors_Local;
+	TArray<FColor> referenceDecodedColors_Local;
+
+	TestTrue(TEXT("Decodes what was encoded"), FVertexColorsSerializedString::Decode(serializedColors_Local, decodedColors_Local));
+	TestTrue(TEXT("Reference decodes what was encoded"), FVertexColorsSerializedString::Decode_Reference(serializedColors_Local, referenceDecodedColors_Local));
+	TestTrue(TEXT("Decoded colors are the ones that was encoded"), decodedColors_Local == vertexColors_Local);
+	TestTrue(TEXT("Reference decoded colors are the ones that was encoded"), referenceDecodedColors_Local == vertexColors_Local);
+
+
+	// Lower case and invalid digits has to give the same as FColor::FromHex, which reads invalid digits as 0
+	const FString unusualSerializedColors_Local = TEXT("ff00aa7fzz12G4x9") + serializedColors_Local.ToLower();
+
+	FVertexColorsSerializedString::Decode(unusualSerializedColors_Local, decodedColors_Local);
+	FVertexColorsSerializedString::Decode_Reference(unusualSerializedColors_Local, referenceDecodedColors_Local);
+
+	TestTrue(TEXT("Lower case and invalid digits decodes the same as the reference"), decodedColors_Local == referenceDecodedColors_Local);
+
+
+	// Every chunk but the last is 64k colors, so this is split into several where the last isn't full
+	IConsoleVariable* parallelColorThresholdCVar_Local = IConsoleManager::Get().FindConsoleVariable(TEXT("VertexPaint.SerializedColors.ParallelColorThreshold"));
+	const int32 parallelColorThreshold_Local = parallelColorThresholdCVar_Local ? parallelColorThresholdCVar_Local->GetInt() : 0;
+
+	if (parallelColorThresholdCVar_Local)
+		parallelColorThresholdCVar_Local->Set(1, ECVF_SetByCode);
+
+	TArray<FColor> largeVertexColors_Local;
+	largeVertexColors_Local.SetNumUninitialized(64 * 1024 * 3 + 17);
+
+	for (FColor& vertexColorTemp : largeVertexColors_Local)
+		vertexColorTemp = FColor(randomStream_Local.RandRange(0, 255), randomStream_Local.RandRange(0, 255), randomStream_Local.RandRange(0, 255), randomStream_Local.RandRange(0, 255));
+
+	FVertexColorsSerializedString::Decode(FVertexColorsSerializedString::Encode(largeVertexColors_Local), decodedColors_Local);
+
+	TestTrue(TEXT("Decoding in parallel chunks gives the colors that was encoded"), decodedColors_Local == largeVertexColors_Local);
+
+	if (parallelColorThresholdCVar_Local)
+		parallelColorThresholdCVar_Local->Set(parallelColorThreshold_Local, ECVF_SetByCode);
+
+
+	TestFalse(TEXT("Empty strings are rejected"), FVertexColorsSerializedString::Decode(FString(), decodedColors_Local));
+	TestFalse(TEXT("Strings that aren't a whole number of colors are rejected"), FVertexColorsSerializedString::Decode(serializedColors_Local.LeftChop(3), decodedColors_Local));
+	TestEqual(TEXT("Rejected strings leaves no colors"), decodedColors_Local.Num(), 0);
+
+	return true;
+}
+
+
+//-------------------------------------------------------
+
+// Vertex Colors Patch Test
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVertexColorsPatchTest, "VertexPaint.Tests.Patch", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FVertexColorsPatchTest::RunTest(const FString& Parameters) {
+
+	FRandomStream randomStream_Local(4242);
+
+	TArray<FColor> fromColors_Local;
+	fromColors_Local.Init(FColor::White, 5000);
+
+	// Scattered single vertices, a long run of the same color, a span of different colors, and the very last vertex, so every kind of span and run is in the patch
+	TArray<FColor> toColors_Local = fromColors_Local;
+
+	for (int32 i = 0; i < 50; i++)
+		toColors_Local[randomStream_Local.RandRange(0, toColors_Local.Num() - 1)] = FColor(randomStream_Local.RandRange(0, 255), randomStream_Local.RandRange(0, 255), randomStream_Local.RandRange(0, 255), randomStream_Local.RandRange(0, 255));
+
+	for (int32 i = 1000; i < 1600; i++)
+		toColors_Local[i] = FColor::Red;
+
+	for (int32 i = 3000; i < 3040; i++)
+		toColors_Local[i] = FColor(i % 256, 0, 255, 128);
+
+	toColors_Local.Last() = FColor::Blue;
+
+
+	TArray<uint8> patch_Local;
+
+	TestTrue(TEXT("Computes a patch between arrays of the same length"), FVertexColorsPatch::Compute(fromColors_Local, toColors_Local, patch_Local));
+
+	TArray<FColor> patchedColors_Local = fromColors_Local;
+
+	TestTrue(TEXT("Applies the patch"), FVertexColorsPatch::Apply(patchedColors_Local, patch_Local));
+	TestTrue(TEXT("Patched colors are the colors the patch was computed to"), patchedColors_Local == toColors_Local);
+
+
+	TArray<uint8> emptyPatch_Local;
+	FVertexColorsPatch::Compute(fromColors_Local, fromColors_Local, emptyPatch_Local);
+
+	TestEqual(TEXT("A patch between equal arrays is only the header"), emptyPatch_Local.Num(), FVertexColorsPatchHeader::SerializedSize);
+
+	patchedColors_Local = fromColors_Local;
+	TestTrue(TEXT("Applying an empty patch succeeds"), FVertexColorsPatch::Apply(patchedColors_Local, emptyPatch_Local));
+	TestTrue(TEXT("Applying an empty patch changes nothing"), patchedColors_Local == fromColors_Local);
+
+	TestFalse(TEXT("Can't compute a patch between arrays of different lengths"), FVertexColorsPatch::Compute(fromColors_Local, TArray<FColor>({ FColor::Red }), patch_Local));
+	FVertexColorsPatch::Compute(fromColors_Local, toColors_Local, patch_Local);
+
+
+	// Every corrupt patch has to be rejected without touching the colors
+	TArray<TArray<uint8>> corruptPatches_Local;
+
+	TArray<uint8> wrongMagic_Local = patch_Local;
+	wrongMagic_Local[0] ^= 0xFF;
+	corruptPatches_Local.Add(wrongMagic_Local);
+
+	TArray<uint8> newerVersion_Local = patch_Local;
+	newerVersion_Local[4] = static_cast<uint8>(FVertexColorsPatchHeader::CurrentVersion + 1);
+	corruptPatches_Local.Add(newerVersion_Local);
+
+	corruptPatches_Local.Add(TArray<uint8>(patch_Local.GetData(), FVertexColorsPatchHeader::SerializedSize - 1));
+	corruptPatches_Local.Add(TArray<uint8>(patch_Local.GetData(), patch_Local.Num() - 1));
+	corruptPatches_Local.Add(TArray<uint8>(patch_Local.GetData(), patch_Local.Num() - 6));
+
+	// A span that skips past the end of the mesh
+	TArray<uint8> skipsPastEnd_Local = patch_Local;
+	skipsPastEnd_Local.Append({ 0xFF, 0xFF, 0x03, 0x01, 0x01, 0x00, 0x00, 0xFF, 0xFF });
+	corruptPatches_Local.Add(skipsPastEnd_Local);
+
+	// The spans don't add up to what the header says changed
+	TArray<uint8> wrongAmountOfChanged_Local = patch_Local;
+	wrongAmountOfChanged_Local[10] ^= 0x01;
+	corruptPatches_Local.Add(wrongAmountOfChanged_Local);
+
+	for (int32 i = 0; i < corruptPatches_Local.Num(); i++) {
+
+		patchedColors_Local = fromColors_Local;
+
+		TestFalse(FString::Printf(TEXT("Corrupt patch %i is rejected"), i), FVertexColorsPatch::Apply(patchedColors_Local, corruptPatches_Local[i]));
+		TestTrue(FString::Printf(TEXT("Corrupt patch %i leaves the colors as they were"), i), patchedColors_Local == fromColors_Local);
+	}
+
+
+	TArray<FColor> otherAmountOfVertices_Local;
+	otherAmountOfVertices_Local.Init(FColor::White, fromColors_Local.Num() - 1);
+
+	TestFalse(TEXT("A patch for another amount of vertices is rejected"), FVertexColorsPatch::Apply(otherAmountOfVertices_Local, patch_Local));
+
+
+	// Same amount of vertices but not the colors it was made from, e.g. if other paint got applied first
+	TArray<FColor> otherBaseColors_Local = fromColors_Local;
+	otherBaseColors_Local[0] = FColor::Green;
+
+	TArray<FColor> patchedOtherBaseColors_Local = otherBaseColors_Local;
+
+	TestFalse(TEXT("A patch made from other colors is rejected"), FVertexColorsPatch::Apply(patchedOtherBaseColors_Local, patch_Local));
+	TestTrue(TEXT("A patch made from other colors leaves them as they were"), patchedOtherBaseColors_Local == otherBaseColors_Local);
+
+
+	// Version 1 patches has no base hash, so they're still applied to any colors with the right amount of vertices
+	TArray<uint8> version1Patch_Local = patch_Local;
+	version1Patch_Local[4] = 1;
+	version1Patch_Local.RemoveAt(FVertexColorsPatchHeader::SerializedSizeVersion1, FVertexColorsPatchHeader::SerializedSize - FVertexColorsPatchHeader::SerializedSizeVersion1);
+
+	patchedColors_Local = fromColors_Local;
+	TestTrue(TEXT("Applies a version 1 patch"), FVertexColorsPatch::Apply(patchedColors_Local, version1Patch_Local));
+	TestTrue(TEXT("Version 1 patched colors are the colors the patch was computed to"), patchedColors_Local == toColors_Local);
+
+	return true;
+}
+
+
+//-------------------------------------------------------
+
+// Vertex Colors Binary Format Test
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVertexColorsBinaryFormatTest, "VertexPaint.Tests.BinaryFormat", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FVertexColorsBinaryFormatTest::RunTest(const FString& Parameters) {
+
+	FRandomStream randomStream_Local(2024);
+
+	// Default White with a few painted areas, like a mesh that has been painted a bit, so every codec can make it smaller
+	TArray<FColor> sourceMeshColors_Local;
+	sourceMeshColors_Local.Init(FColor::White, 4000);
+
+	TArray<FColor> vertexColors_Local = sourceMeshColors_Local;
+
+	for (int32 i = 500; i < 900; i++)
+		vertexColors_Local[i] = FColor(255, 0, 0, 255);
+
+	for (int32 i = 0; i < 30; i++)
+		vertexColors_Local[randomStream_Local.RandRange(0, vertexColors_Local.Num() - 1)] = FColor(randomStream_Local.RandRange(0, 255), randomStream_Local.RandRange(0, 255), randomStream_Local.RandRange(0, 255), randomStream_Local.RandRange(0, 255));
+
+
+	TArray<EVertexColorsBinaryCompression> compressions_Local = { EVertexColorsBinaryCompression::None, EVertexColorsBinaryCompression::LZ4 };
+
+#if ENGINE_MAJOR_VERSION == 5
+	compressions_Local.Add(EVertexColorsBinaryCompression::Oodle);
+#endif
+
+	for (EVertexColorsBinaryCompression compressionTemp : compressions_Local) {
+
+		for (int32 deltaEncode_Local = 0; deltaEncode_Local < 2; deltaEncode_Local++) {
+
+			const FString testCase_Local = FString::Printf(TEXT("compression %i, %s"), static_cast<int32>(compressionTemp), deltaEncode_Local ? TEXT("delta encoded") : TEXT("not delta encoded"));
+			const TArray<FColor> emptyColors_Local;
+			const TArray<FColor>& encodeAgainstColors_Local = deltaEncode_Local ? sourceMeshColors_Local : emptyColors_Local;
+
+			TArray<uint8> binaryColorData_Local;
+			TestTrue(FString::Printf(TEXT("Encodes with %s"), *testCase_Local), FVertexColorsBinaryFormat::Encode(vertexColors_Local, nullptr, encodeAgainstColors_Local, compressionTemp, binaryColorData_Local));
+
+			FVertexColorsBinaryHeader header_Local;
+			TestTrue(FString::Printf(TEXT("Reads the header with %s"), *testCase_Local), FVertexColorsBinaryFormat::ReadHeader(binaryColorData_Local, header_Local));
+			TestEqual(FString::Printf(TEXT("Header has the amount of vertices with %s"), *testCase_Local), header_Local.amountOfVertices, vertexColors_Local.Num());
+			TestEqual(FString::Printf(TEXT("Header says if it's delta encoded with %s"), *testCase_Local), header_Local.IsDeltaEncoded(), deltaEncode_Local == 1);
+			TestTrue(FString::Printf(TEXT("Header has the compression that was used with %s"), *testCase_Local), header_Local.compression == compressionTemp);
+
+			TArray<FColor> decodedColors_Local;
+			TestTrue(FString::Printf(TEXT("Decodes with %s"), *testCase_Local), FVertexColorsBinaryFormat::Decode(binaryColorData_Local, nullptr, encodeAgainstColors_Local, decodedColors_Local));
+			TestTrue(FString::Printf(TEXT("Decoded colors are the ones that was encoded with %s"), *testCase_Local), decodedColors_Local == vertexColors_Local);
+
+			TestFalse(FString::Printf(TEXT("Data for another source mesh is rejected with %s"), *testCase_Local), FVertexColorsBinaryFormat::Decode(binaryColorData_Local, GetTransientPackage(), encodeAgainstColors_Local, decodedColors_Local));
+			TestFalse(FString::Printf(TEXT("Truncated data is rejected with %s"), *testCase_Local), FVertexColorsBinaryFormat::Decode(TArray<uint8>(binaryColorData_Local.GetData(), binaryColorData_Local.Num() - 1), nullptr, encodeAgainstColors_Local, decodedColors_Local));
+
+			if (deltaEncode_Local)
+				TestFalse(FString::Printf(TEXT("Delta encoded data is rejected without the source mesh colors with %s"), *testCase_Local), FVertexColorsBinaryFormat::Decode(binaryColorData_Local, nullptr, emptyColors_Local, decodedColors_Local));
+		}
+	}
+
+
+	// Colors that can't be compressed are stored as they are, which has to decode the same
+	TArray<FColor> noisyVertexColors_Local;
+	noisyVertexColors_Local.SetNumUninitialized(4000);
+
+	for (FColor& vertexColorTemp : noisyVertexColors_Local)
+		vertexColorTemp = FColor(randomStream_Local.RandRange(0, 255), randomStream_Local.RandRange(0, 255), randomStream_Local.RandRange(0, 255), randomStream_Local.RandRange(0, 255));
+
+	TArray<uint8> noisyBinaryColorData_Local;
+	TArray<FColor> noisyDecodedColors_Local;
+	FVertexColorsBinaryHeader noisyHeader_Local;
+
+	FVertexColorsBinaryFormat::Encode(noisyVertexColors_Local, nullptr, TArray<FColor>(), EVertexColorsBinaryCompression::LZ4, noisyBinaryColorData_Local);
+	FVertexColorsBinaryFormat::ReadHeader(noisyBinaryColorData_Local, noisyHeader_Local);
+
+	TestTrue(TEXT("Colors that can't be compressed are stored uncompressed"), noisyHeader_Local.compression == EVertexColorsBinaryCompression::None);
+	TestTrue(TEXT("Colors that can't be compressed decodes"), FVertexColorsBinaryFormat::Decode(noisyBinaryColorData_Local, nullptr, TArray<FColor>(), noisyDecodedColors_Local) && noisyDecodedColors_Local == noisyVertexColors_Local);
+
+
+#if ENGINE_MAJOR_VERSION == 5
+
+	// Dynamic Meshes has their colors on the CPU, so decoding for an actual component can be tested without cooked render data
+	UDynamicMeshComponent* dynamicMeshComponent_Local = NewObject<UDynamicMeshComponent>(GetTransientPackage());
+
+	UE::Geometry::FDynamicMesh3 dynamicMesh3_Local(false, true, false, false);
+
+	for (int32 i = 0; i < 1000; i++)
+		dynamicMesh3_Local.AppendVertex(UE::Geometry::FVertexInfo(FVector3d(i, 0, 0), FVector3f::ZAxisVector, FVector3f(i % 2, 0, 1)));
+
+	dynamicMeshComponent_Local->GetDynamicMesh()->SetMesh(MoveTemp(dynamicMesh3_Local));
+
+	TArray<uint8> componentBinaryColorData_Local;
+	TArray<FColor> componentDecodedColors_Local;
+
+	TestTrue(TEXT("Encodes the colors of a component"), VertexPaintFunctions::GetMeshComponentVertexColorsAsBinary(dynamicMeshComponent_Local, false, componentBinaryColorData_Local));
+	TestTrue(TEXT("Decodes the colors of a component"), VertexPaintFunctions::GetVertexColorsFromBinary(dynamicMeshComponent_Local, componentBinaryColorData_Local, componentDecodedColors_Local));
+	TestTrue(TEXT("Decoded colors are the colors of the component"), componentDecodedColors_Local == VertexPaintFunctions::GetDynamicMeshVertexColors(dynamicMeshComponent_Local));
+
+	// A header that claims far more vertices than the component has, which would otherwise be allocated for before the payload is found to be too short
+	TArray<uint8> craftedBinaryColorData_Local = componentBinaryColorData_Local;
+	const int32 craftedAmountOfVertices_Local = MAX_int32 / 4;
+	FMemory::Memcpy(craftedBinaryColorData_Local.GetData() + 16, &craftedAmountOfVertices_Local, 4);
+
+	FVertexColorsBinaryHeader craftedHeader_Local;
+	TestTrue(TEXT("The crafted header is valid on its own"), FVertexColorsBinaryFormat::ReadHeader(craftedBinaryColorData_Local, craftedHeader_Local) && craftedHeader_Local.amountOfVertices == craftedAmountOfVertices_Local);
+	TestFalse(TEXT("Data with another amount of vertices than the component is rejected"), VertexPaintFunctions::GetVertexColorsFromBinary(dynamicMeshComponent_Local, craftedBinaryColorData_Local, componentDecodedColors_Local));
+	TestEqual(TEXT("Rejected data leaves no colors"), componentDecodedColors_Local.Num(), 0);
+
+	dynamicMeshComponent_Local->MarkAsGarbage();
+
+#endif
+
+	return true;
+}
+
+
+//-------------------------------------------------------
+
+// Compressed Vertex Colors Test
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCompressedVertexColorsTest, "VertexPaint.Tests.CompressedVertexColors", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FCompressedVertexColorsTest::RunTest(const FString& Parameters) {
+
+	FRandomStream randomStream_Local(777);
+
+	auto testRoundTrip = [this](const TCHAR* testCase, const TArray<FColor>& vertexColors) {
+
+		const FCompressedVertexColors compressedVertexColors_Local = FCompressedVertexColors::Compress(vertexColors);
+
+		TArray<FColor> decompressedColors_Local;
+		compressedVertexColors_Local.Decompress(decompressedColors_Local);
+
+		TestEqual(FString::Printf(TEXT("%s keeps the amount of vertices"), testCase), compressedVertexColors_Local.GetAmountOfVertices(), vertexColors.Num());
+		TestTrue(FString::Printf(TEXT("%s decompresses to the colors that was compressed"), testCase), decompressedColors_Local == vertexColors);
+
+		return compressedVertexColors_Local;
+	};
+
+
+	testRoundTrip(TEXT("A single vertex"), TArray<FColor>({ FColor(12, 34, 56, 78) }));
+	testRoundTrip(TEXT("No vertices"), TArray<FColor>());
+
+
+	// Runs of 1, 127, 128 and 20000 vertices, so run lengths takes 1, 2 and 3 varint bytes
+	TArray<FColor> longRuns_Local;
+	longRuns_Local.Add(FColor::Red);
+	longRuns_Local.Add(FColor::Green);
+
+	for (const TPair<FColor, int32>& runTemp : TArray<TPair<FColor, int32>>({ { FColor::Blue, 127 }, { FColor::White, 128 }, { FColor::Black, 20000 }, { FColor::Red, 1 } })) {
+
+		for (int32 i = 0; i < runTemp.Value; i++)
+			longRuns_Local.Add(runTemp.Key);
+	}
+
+	const FCompressedVertexColors longRunsCompressed_Local = testRoundTrip(TEXT("Runs longer than 127"), longRuns_Local);
+	TestTrue(TEXT("Long runs are smaller compressed"), longRunsCompressed_Local.GetAllocatedSize() < longRuns_Local.Num() * static_cast<int64>(sizeof(FColor)) / 100);
+
+
+	// Exactly 256 distinct colors is the most the palette can index, with runs between them so both the palette and the runs are used
+	TArray<FColor> paletteColors_Local;
+
+	for (int32 i = 0; i < 256; i++) {
+
+		for (int32 j = 0; j < 3 + i % 5; j++)
+			paletteColors_Local.Add(FColor(i, 255 - i, i / 2, 255));
+	}
+
+	testRoundTrip(TEXT("256 distinct colors with the palette"), paletteColors_Local);
+
+
+	// One more distinct color than the palette can index falls back to storing whole colors, including for the colors before it
+	TArray<FColor> tooManyColors_Local = paletteColors_Local;
+	tooManyColors_Local.Add(FColor(1, 2, 3, 4));
+	tooManyColors_Local.Append(paletteColors_Local);
+
+	testRoundTrip(TEXT("More than 256 distinct colors"), tooManyColors_Local);
+
+
+	TArray<FColor> noisyColors_Local;
+	noisyColors_Local.SetNumUninitialized(5000);
+
+	for (FColor& vertexColorTemp : noisyColors_Local)
+		vertexColorTemp = FColor(randomStream_Local.RandRange(0, 255), randomStream_Local.RandRange(0, 255), randomStream_Local.RandRange(0, 255), randomStream_Local.RandRange(0, 255));
+
+	testRoundTrip(TEXT("Random colors without runs"), noisyColors_Local);
+
+	return true;
+}
+
+#endif
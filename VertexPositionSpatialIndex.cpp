@@ -0,0 +1,168 @@
+#include "VertexPositionSpatialIndex.h"
+#include "Engine/StaticMesh.h"
+#include "StaticMeshResources.h"
+
+
+FCriticalSection FVertexPositionSpatialIndex::spatialIndicesCriticalSection;
+TMap<FVertexPositionSpatialIndex::FSpatialIndexKey, TSharedPtr<const FVertexPositionSpatialIndex, ESPMode::ThreadSafe>> FVertexPositionSpatialIndex::spatialIndicesPerMeshLOD;
+
+
+//-------------------------------------------------------
+
+// Get Or Build
+
+TSharedPtr<const FVertexPositionSpatialIndex, ESPMode::ThreadSafe> FVertexPositionSpatialIndex::GetOrBuild(const UStaticMesh* staticMesh, int32 lod) {
+
+	if (!IsValid(staticMesh)) return nullptr;
+	if (!staticMesh->bAllowCPUAccess) return nullptr;
+	if (!staticMesh->GetRenderData()) return nullptr;
+	if (!staticMesh->GetRenderData()->LODResources.IsValidIndex(lod)) return nullptr;
+
+
+	const FPositionVertexBuffer& positionVertexBuffer_Local = staticMesh->GetRenderData()->LODResources[lod].VertexBuffers.PositionVertexBuffer;
+	const int32 amountOfVertices_Local = positionVertexBuffer_Local.GetNumVertices();
+
+	{
+		FScopeLock scopeLock_Local(&spatialIndicesCriticalSection);
+
+		const TSharedPtr<const FVertexPositionSpatialIndex, ESPMode::ThreadSafe>* cachedSpatialIndex_Local = spatialIndicesPerMeshLOD.Find({ staticMesh, lod });
+
+		// If the vertex amount changed the mesh has been rebuilt since, so we build a new one
+		if (cachedSpatialIndex_Local && (*cachedSpatialIndex_Local)->GetAmountOfVertices() == amountOfVertices_Local)
+			return *cachedSpatialIndex_Local;
+	}
+
+
+	TArray<FVertexPosition> localVertexPositions_Local;
+	localVertexPositions_Local.SetNumUninitialized(amountOfVertices_Local);
+
+	for (int32 i = 0; i < amountOfVertices_Local; i++)
+		localVertexPositions_Local[i] = positionVertexBuffer_Local.VertexPosition(i);
+
+	TSharedPtr<const FVertexPositionSpatialIndex, ESPMode::ThreadSafe> spatialIndex_Local = MakeShared<FVertexPositionSpatialIndex, ESPMode::ThreadSafe>(MoveTemp(localVertexPositions_Local));
+
+
+	FScopeLock scopeLock_Local(&spatialIndicesCriticalSection);
+
+	// Clears out meshes that has been unloaded
+	for (auto it = spatialIndicesPerMeshLOD.CreateIterator(); it; ++it) {
+
+		if (!it.Key().staticMesh.IsValid())
+			it.RemoveCurrent();
+	}
+
+	spatialIndicesPerMeshLOD.Add({ staticMesh, lod }, spatialIndex_Local);
+
+	return spatialIndex_Local;
+}
+
+
+//-------------------------------------------------------
+
+// Constructor
+
+FVertexPositionSpatialIndex::FVertexPositionSpatialIndex(TArray<FVertexPosition>&& vertexPositions) :
+
+	localVertexPositions(MoveTemp(vertexPositions)),
+	localBounds(ForceInit),
+	cellSize(FVector::OneVector),
+	amountOfCells(1, 1, 1) {
+
+	if (localVertexPositions.Num() <= 0) {
+
+		cellFirstVertex.Init(0, 2);
+		return;
+	}
+
+
+	for (const FVertexPosition& localVertexPositionTemp : localVertexPositions)
+		localBounds += FVector(localVertexPositionTemp);
+
+
+	// Aims for around 16 vertices per cell on average, with the cells as close to cubes as the bounds allows
+	const FVector boundsSize_Local = localBounds.GetSize().ComponentMax(FVector(1, 1, 1));
+	const double boundsVolume_Local = boundsSize_Local.X * boundsSize_Local.Y * boundsSize_Local.Z;
+	const double amountOfCellsToAimFor_Local = FMath::Max(1.0, localVertexPositions.Num() / 16.0);
+	const double cellLength_Local = FMath::Pow(boundsVolume_Local / amountOfCellsToAimFor_Local, 1.0 / 3.0);
+
+	amountOfCells.X = FMath::Clamp(FMath::CeilToInt(boundsSize_Local.X / cellLength_Local), 1, 256);
+	amountOfCells.Y = FMath::Clamp(FMath::CeilToInt(boundsSize_Local.Y / cellLength_Local), 1, 256);
+	amountOfCells.Z = FMath::Clamp(FMath::CeilToInt(boundsSize_Local.Z / cellLength_Local), 1, 256);
+
+	cellSize = boundsSize_Local / FVector(amountOfCells);
+
+
+	// Counting sort of the vertices by their cell, so every cell's vertices are next to each other
+	const int32 totalAmountOfCells_Local = amountOfCells.X * amountOfCells.Y * amountOfCells.Z;
+
+	TArray<int32> vertexCellIndices_Local;
+	vertexCellIndices_Local.SetNumUninitialized(localVertexPositions.Num());
+
+	cellFirstVertex.Init(0, totalAmountOfCells_Local + 1);
+
+	for (int32 i = 0; i < localVertexPositions.Num(); i++) {
+
+		vertexCellIndices_Local[i] = GetCellIndex(GetCellCoordinates(FVector(localVertexPositions[i])));
+		cellFirstVertex[vertexCellIndices_Local[i] + 1]++;
+	}
+
+	for (int32 i = 0; i < totalAmountOfCells_Local; i++)
+		cellFirstVertex[i + 1] += cellFirstVertex[i];
+
+
+	TArray<int32> cellFillAmount_Local;
+	cellFillAmount_Local.Init(0, totalAmountOfCells_Local);
+
+	vertexIndicesSortedByCell.SetNumUninitialized(localVertexPositions.Num());
+
+	for (int32 i = 0; i < localVertexPositions.Num(); i++) {
+
+		const int32 cellIndex_Local = vertexCellIndices_Local[i];
+		vertexIndicesSortedByCell[cellFirstVertex[cellIndex_Local] + cellFillAmount_Local[cellIndex_Local]++] = i;
+	}
+}
+
+
+//-------------------------------------------------------
+
+// Get Cell Coordinates
+
+FIntVector FVertexPositionSpatialIndex::GetCellCoordinates(const FVector& localPosition) const {
+
+	const FVector positionInBounds_Local = (localPosition - localBounds.Min) / cellSize;
+
+	return FIntVector(
+		FMath::Clamp(FMath::FloorToInt(positionInBounds_Local.X), 0, amountOfCells.X - 1),
+		FMath::Clamp(FMath::FloorToInt(positionInBounds_Local.Y), 0, amountOfCells.Y - 1),
+		FMath::Clamp(FMath::FloorToInt(positionInBounds_Local.Z), 0, amountOfCells.Z - 1));
+}
+
+
+//-------------------------------------------------------
+
+// Get Vertices In Cells Overlapping Box
+
+void FVertexPositionSpatialIndex::GetVerticesInCellsOverlappingBox(const FBox& localBox, TArray<int32>& candidateVertexIndices) const {
+
+	if (localVertexPositions.Num() <= 0) return;
+	if (!localBox.IsValid || !localBox.Intersect(localBounds)) return;
+
+
+	const FIntVector minCell_Local = GetCellCoordinates(localBox.Min);
+	const FIntVector maxCell_Local = GetCellCoordinates(localBox.Max);
+
+	for (int32 z = minCell_Local.Z; z <= maxCell_Local.Z; z++) {
+
+		for (int32 y = minCell_Local.Y; y <= maxCell_Local.Y; y++) {
+
+			// Cells along X are next to each other so the whole row of vertices is one contiguous range
+			const int32 rowFirstCellIndex_Local = GetCellIndex(FIntVector(minCell_Local.X, y, z));
+			const int32 rowLastCellIndex_Local = GetCellIndex(FIntVector(maxCell_Local.X, y, z));
+
+			const int32 rowFirstVertex_Local = cellFirstVertex[rowFirstCellIndex_Local];
+			const int32 rowEndVertex_Local = cellFirstVertex[rowLastCellIndex_Local + 1];
+
+			candidateVertexIndices.Append(vertexIndicesSortedByCell.GetData() + rowFirstVertex_Local, rowEndVertex_Local - rowFirstVertex_Local);
+		}
+	}
+}
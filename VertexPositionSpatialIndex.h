@@ -0,0 +1,70 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+class UStaticMesh;
+
+
+//-------------------------------------------------------
+
+// Vertex Position Spatial Index
+
+// Uniform grid over the local space vertex positions of a mesh LOD, so queries like which vertices are within a couple of meters of a location only has to look at the vertices in the cells the area overlaps instead of every vertex on the mesh. It's in local space so it's built once per source mesh asset and LOD and shared between every component that uses the mesh, no matter where they are or how they're scaled.
+
+class FVertexPositionSpatialIndex {
+
+public:
+
+#if ENGINE_MAJOR_VERSION == 5
+	typedef FVector3f FVertexPosition;
+#else
+	typedef FVector FVertexPosition;
+#endif
+
+
+	// Gets the cached index for the mesh and LOD, or builds it if it hasn't been built yet. The mesh has to allow CPU Access, same as when reading its colors. 
+	static TSharedPtr<const FVertexPositionSpatialIndex, ESPMode::ThreadSafe> GetOrBuild(const UStaticMesh* staticMesh, int32 lod);
+
+	explicit FVertexPositionSpatialIndex(TArray<FVertexPosition>&& localVertexPositions);
+
+	// Adds every vertex in the cells that the local space box overlaps. These are the candidates, so the caller still has to check if each of them is actually inside its shape. 
+	void GetVerticesInCellsOverlappingBox(const FBox& localBox, TArray<int32>& candidateVertexIndices) const;
+
+	const FVertexPosition& GetLocalVertexPosition(int32 vertexIndex) const { return localVertexPositions[vertexIndex]; }
+
+	int32 GetAmountOfVertices() const { return localVertexPositions.Num(); }
+
+
+private:
+
+	FIntVector GetCellCoordinates(const FVector& localPosition) const;
+
+	int32 GetCellIndex(const FIntVector& cellCoordinates) const { return cellCoordinates.X + cellCoordinates.Y * amountOfCells.X + cellCoordinates.Z * amountOfCells.X * amountOfCells.Y; }
+
+
+	TArray<FVertexPosition> localVertexPositions;
+
+	FBox localBounds;
+	FVector cellSize;
+	FIntVector amountOfCells;
+
+	// The vertex indices sorted by cell, where the vertices in a cell are from cellFirstVertex[cell] up to cellFirstVertex[cell + 1]
+	TArray<int32> cellFirstVertex;
+	TArray<int32> vertexIndicesSortedByCell;
+
+
+	struct FSpatialIndexKey {
+
+		TWeakObjectPtr<const UStaticMesh> staticMesh;
+		int32 lod = 0;
+
+		bool operator==(const FSpatialIndexKey& other) const { return staticMesh == other.staticMesh && lod == other.lod; }
+
+		friend uint32 GetTypeHash(const FSpatialIndexKey& spatialIndexKey) { return HashCombine(GetTypeHash(spatialIndexKey.staticMesh), GetTypeHash(spatialIndexKey.lod)); }
+	};
+
+	static FCriticalSection spatialIndicesCriticalSection;
+	static TMap<FSpatialIndexKey, TSharedPtr<const FVertexPositionSpatialIndex, ESPMode::ThreadSafe>> spatialIndicesPerMeshLOD;
+};